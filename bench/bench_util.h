@@ -0,0 +1,22 @@
+#ifndef QOLOR_BENCH_UTIL_H__
+#define QOLOR_BENCH_UTIL_H__
+
+#include <chrono>
+
+typedef std::chrono::steady_clock clock_type;
+
+// Best time of runs calls of func, in milliseconds.
+template <typename Func>
+double best_of(int const& runs, Func&& func)
+{
+	double best = 0;
+	for (int i = 0; i < runs; ++i) {
+		auto start = clock_type::now();
+		func();
+		std::chrono::duration<double, std::milli> ms = clock_type::now() - start;
+		if (i == 0 || ms.count() < best) best = ms.count();
+	}
+	return best;
+}
+
+#endif // QOLOR_BENCH_UTIL_H__
@@ -0,0 +1,62 @@
+// Queries of one column over rows loaded in memory: a vector of tuples
+// (to_vector) compared to a column_table (to_columns), where the column is a
+// contiguous array.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile double result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const n = (argc > 1)? std::stoul(argv[1]) : 4000000;
+	int const runs = 10;
+	typedef std::tuple<int, int, double, double> row_t;
+
+	auto const rows = qolor::range(0, int(n))
+		.select([](int const& i) { return row_t(i % 1000, i % 7, i * 0.25, i * 0.5); })
+		.to_vector();
+	auto const table = qolor::from(rows).to_columns();
+
+	double rows_sum = best_of(runs, [&]() {
+		result = qolor::from(rows).select([](row_t const& r) { return std::get<2>(r); }).sum();
+	});
+	double column_sum = best_of(runs, [&]() { result = qolor::from<2>(table).sum(); });
+
+	double rows_count = best_of(runs, [&]() {
+		result = double(qolor::from(rows).where([](row_t const& r) { return std::get<0>(r) == 7; }).count());
+	});
+	double column_count = best_of(runs, [&]() { result = double(qolor::from<0>(table).count(7)); });
+
+	double rows_pair = best_of(runs, [&]() {
+		result = qolor::from(rows)
+			.where([](row_t const& r) { return std::get<1>(r) == 3; })
+			.select([](row_t const& r) { return std::get<3>(r); }).sum();
+	});
+	double column_pair = best_of(runs, [&]() {
+		result = qolor::from<1, 3>(table)
+			.where([](std::tuple<int, double> const& r) { return std::get<0>(r) == 3; })
+			.select([](std::tuple<int, double> const& r) { return std::get<1>(r); }).sum();
+	});
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:                       " << n << " x (int, int, double, double)" << std::endl;
+	std::cout << "sum of a column, tuples     " << rows_sum << " ms" << std::endl;
+	std::cout << "sum of a column, columns    " << column_sum << " ms (x" << rows_sum / column_sum << ")" << std::endl;
+	std::cout << "count in a column, tuples   " << rows_count << " ms" << std::endl;
+	std::cout << "count in a column, columns  " << column_count << " ms (x" << rows_count / column_count << ")" << std::endl;
+	std::cout << "two columns, tuples         " << rows_pair << " ms" << std::endl;
+	std::cout << "two columns, columns        " << column_pair << " ms (x" << rows_pair / column_pair << ")" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,72 @@
+// Loading the same data again, as a restart would: parsing a CSV file
+// compared to reading a columnar file written from it, with all the columns,
+// one column, and a range that skips most blocks.
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile double result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 1000000;
+	int const runs = 5;
+	std::string const csv_path = "bench_columnar_file.csv";
+	std::string const path = "bench_columnar_file.qcol";
+
+	{
+		std::ofstream os(csv_path, std::ios::binary);
+		for (size_t i = 0; i < rows; ++i)
+			os << i << ',' << (i * 7919) % 100000 << ',' << double(i % 1000) / 4 << ",name " << i % 97 << '\n';
+	}
+	qolor::from_csv_file<long, int, double, std::string>(csv_path).to_columnar_file(path, { "id", "key", "price", "name" });
+
+	double csv = best_of(runs, [&]() {
+		double sum = 0;
+		for (auto const& t : qolor::from_csv_file<long, int, double, std::string>(csv_path)) sum += std::get<2>(t);
+		result = sum;
+	});
+
+	double all = best_of(runs, [&]() {
+		double sum = 0;
+		for (auto const& t : qolor::from_columnar_file<long, int, double, std::string>(path)) sum += std::get<2>(t);
+		result = sum;
+	});
+
+	double one = best_of(runs, [&]() {
+		double sum = 0;
+		for (auto const& t : qolor::from_columnar_file<double>(path, qolor::columns({ "price" }))) sum += std::get<0>(t);
+		result = sum;
+	});
+
+	double range = best_of(runs, [&]() {
+		double sum = 0;
+		for (auto const& t : qolor::from_columnar_file<double>(path, qolor::columns({ "price" }),
+			qolor::field_filter().between(0, 0, double(rows / 100))))
+			sum += std::get<0>(t);
+		result = sum;
+	});
+
+	std::remove(csv_path.c_str());
+	std::remove(path.c_str());
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:                       " << rows << " x (long, int, double, string)" << std::endl;
+	std::cout << "from_csv_file               " << csv << " ms" << std::endl;
+	std::cout << "from_columnar_file          " << all << " ms (x" << csv / all << ")" << std::endl;
+	std::cout << "from_columnar_file, 1 col   " << one << " ms (x" << csv / one << ")" << std::endl;
+	std::cout << "from_columnar_file, 1% ids  " << range << " ms (x" << csv / range << ")" << std::endl;
+
+	return 0;
+}
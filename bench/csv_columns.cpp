@@ -0,0 +1,80 @@
+// Reading 3 columns out of 80: every field compared to a projection with
+// columns, for the stream driver (from_csv) and the mapped one
+// (from_csv_file).
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile size_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 50000;
+	size_t const width = 80;
+	int const runs = 5;
+	std::string const path = "bench_csv_columns.csv";
+
+	std::string text;
+	for (size_t i = 0; i < rows; ++i) {
+		for (size_t c = 0; c < width; ++c) {
+			if (c) text += ',';
+			text += (c % 10 == 3)? "\"text " + std::to_string(c) + "\"" : std::to_string(i * 31 + c);
+		}
+		text += '\n';
+	}
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+
+	qolor::columns const cols({ 2, 40, 77 });
+
+	double stream_all = best_of(runs, [&]() {
+		std::istringstream is(text);
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv(is)) n += row[2].size() + row[40].size() + row[77].size();
+		result = n;
+	});
+
+	double stream_cols = best_of(runs, [&]() {
+		std::istringstream is(text);
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv(is, cols)) n += row[0].size() + row[1].size() + row[2].size();
+		result = n;
+	});
+
+	double mapped_all = best_of(runs, [&]() {
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv_file(path)) n += row[2].size() + row[40].size() + row[77].size();
+		result = n;
+	});
+
+	double mapped_cols = best_of(runs, [&]() {
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv_file(path, cols)) n += row[0].size() + row[1].size() + row[2].size();
+		result = n;
+	});
+
+	std::remove(path.c_str());
+
+	double const mb = text.size() / 1e6;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:                    " << rows << " x " << width << " (" << mb << " MB)" << std::endl;
+	std::cout << "from_csv                 " << stream_all << " ms" << std::endl;
+	std::cout << "from_csv, 3 columns      " << stream_cols << " ms (x" << stream_all / stream_cols << ")" << std::endl;
+	std::cout << "from_csv_file            " << mapped_all << " ms" << std::endl;
+	std::cout << "from_csv_file, 3 columns " << mapped_cols << " ms (x" << mapped_all / mapped_cols << ")" << std::endl;
+
+	return 0;
+}
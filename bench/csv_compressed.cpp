@@ -0,0 +1,66 @@
+// Reading a .csv.gz file: decompressing it into memory first and parsing it
+// afterwards, on one thread, compared to from_csv_compressed, which parses the
+// rows while another thread decompresses the file.
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <zlib.h>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile size_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 300000;
+	int const runs = 5;
+	std::string const path = "bench_csv_compressed.csv.gz";
+
+	std::string text;
+	for (size_t i = 0; i < rows; ++i)
+		text += std::to_string(i) + ",\"name " + std::to_string(i * 7 % 1000) + "\"," + std::to_string(i % 997) + ".25,"
+			+ std::to_string(i * 31) + "\n";
+	{
+		gzFile f = gzopen(path.c_str(), "wb");
+		gzwrite(f, text.data(), unsigned(text.size()));
+		gzclose(f);
+	}
+
+	double serial = best_of(runs, [&]() {
+		std::string all;
+		gzFile f = gzopen(path.c_str(), "rb");
+		char buf[1 << 16];
+		int n;
+		while ((n = gzread(f, buf, sizeof(buf))) > 0) all.append(buf, size_t(n));
+		gzclose(f);
+		std::istringstream is(all);
+		size_t sum = 0;
+		for (auto const& t : qolor::from_csv<int, qolor::text_view, double, long>(is)) sum += size_t(std::get<0>(t));
+		result = sum;
+	});
+
+	double pipelined = best_of(runs, [&]() {
+		size_t sum = 0;
+		for (auto const& t : qolor::from_csv_compressed<int, qolor::text_view, double, long>(path)) sum += size_t(std::get<0>(t));
+		result = sum;
+	});
+
+	std::remove(path.c_str());
+
+	double const mb = text.size() / 1e6;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:                    " << rows << " (" << mb << " MB), " << std::thread::hardware_concurrency() << " cores" << std::endl;
+	std::cout << "gunzip, then from_csv    " << serial << " ms" << std::endl;
+	std::cout << "from_csv_compressed      " << pipelined << " ms (x" << serial / pipelined << ")" << std::endl;
+
+	return 0;
+}
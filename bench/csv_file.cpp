@@ -0,0 +1,84 @@
+// Throughput of from_csv on an ifstream, which copies every field into a
+// string, compared to from_csv_file, which maps the file and yields views.
+// "parallel" is from_csv_file_parallel with one thread per core.
+// "scan" is the structural scanner alone, over the file in memory: the upper
+// bound of from_csv_file.
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile size_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 1000000;
+	int const runs = 5;
+	std::string const path = "bench_csv_file.csv";
+
+	std::string text;
+	for (size_t i = 0; i < rows; ++i) {
+		text += std::to_string(i) + "," + std::to_string(i * 2654435761u % 100000) +
+			",\"name " + std::to_string(i % 997) + "\",some free text," + std::to_string(i * 0.25) + "\n";
+	}
+	size_t const bytes = text.size();
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+
+	double scan = best_of(runs, [&]() {
+		std::vector<uint32_t> index(qolor::internal::csv::row_parser::window_size);
+		uint64_t in_quotes = 0;
+		size_t n = 0;
+		for (size_t b = 0; b < bytes; b += index.size()) {
+			size_t const len = std::min(index.size(), bytes - b);
+			n += qolor::internal::csv::scan_structurals(text.data() + b, len, ',', in_quotes, index.data());
+		}
+		result = n;
+	});
+
+	double stream = best_of(runs, [&]() {
+		std::ifstream is(path, std::ios::binary);
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv(is)) n += row[2].size();
+		result = n;
+	});
+
+	double mapped = best_of(runs, [&]() {
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv_file(path)) n += row[2].size();
+		result = n;
+	});
+
+	double parallel = best_of(runs, [&]() {
+		size_t n = 0;
+		for (auto const& row : qolor::from_csv_file_parallel(path)) n += row[2].size();
+		result = n;
+	});
+
+	std::remove(path.c_str());
+
+	double const mb = bytes / 1e6;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:          " << rows << " (" << mb << " MB)" << std::endl;
+	std::cout << "scan           " << scan << " ms (" << mb / scan * 1000 << " MB/s)" << std::endl;
+	std::cout << "from_csv       " << stream << " ms (" << mb / stream * 1000 << " MB/s)" << std::endl;
+	std::cout << "from_csv_file  " << mapped << " ms (" << mb / mapped * 1000 << " MB/s)" << std::endl;
+	std::cout << "parallel (x" << std::thread::hardware_concurrency() << ")  " << parallel
+		<< " ms (" << mb / parallel * 1000 << " MB/s)" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Selecting 1% of the rows of a file: a where() on the rows that the driver
+// splits compared to a field_filter that the driver checks before splitting
+// them, for the stream driver (from_csv) and the mapped one (from_csv_file).
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile size_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 200000;
+	size_t const width = 20;
+	int const runs = 5;
+	std::string const path = "bench_csv_filter.csv";
+
+	std::string text;
+	for (size_t i = 0; i < rows; ++i) {
+		text += (i % 100 == 0)? "FR" : "DE";
+		for (size_t c = 1; c < width; ++c) {
+			text += ',';
+			text += (c % 5 == 3)? "\"text " + std::to_string(c) + "\"" : std::to_string(i * 31 + c);
+		}
+		text += '\n';
+	}
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+
+	qolor::columns const all;
+	qolor::field_filter const filter = qolor::field_filter().equals(0, "FR");
+
+	double stream_where = best_of(runs, [&]() {
+		std::istringstream is(text);
+		result = qolor::from_csv(is).where([](std::vector<std::string> const& row) { return row[0] == "FR"; }).count();
+	});
+
+	double stream_filter = best_of(runs, [&]() {
+		std::istringstream is(text);
+		result = qolor::from_csv(is, all, filter).count();
+	});
+
+	double mapped_where = best_of(runs, [&]() {
+		result = qolor::from_csv_file(path).where([](qolor::internal::csv::mapped_row const& row) { return row[0] == "FR"; }).count();
+	});
+
+	double mapped_filter = best_of(runs, [&]() {
+		result = qolor::from_csv_file(path, all, filter).count();
+	});
+
+	std::remove(path.c_str());
+
+	double const mb = text.size() / 1e6;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:                        " << rows << " x " << width << " (" << mb << " MB), 1% selected" << std::endl;
+	std::cout << "from_csv, where              " << stream_where << " ms" << std::endl;
+	std::cout << "from_csv, field_filter       " << stream_filter << " ms (x" << stream_where / stream_filter << ")" << std::endl;
+	std::cout << "from_csv_file, where         " << mapped_where << " ms" << std::endl;
+	std::cout << "from_csv_file, field_filter  " << mapped_filter << " ms (x" << mapped_where / mapped_filter << ")" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+// Decoding rows of numbers: from_csv with std::stoi/std::stod on the fields,
+// which are strings, compared to from_csv<int, int, double, double>, which
+// parses the numbers straight from the line buffer.
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile double result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 500000;
+	int const runs = 5;
+
+	std::string text;
+	for (size_t i = 0; i < rows; ++i) {
+		text += std::to_string(i % 1000) + "," + std::to_string(i * 7 % 1000) + "," +
+			std::to_string(i % 97) + "." + std::to_string(i % 10) + "," + std::to_string(i % 1013) + ".25\n";
+	}
+
+	double strings = best_of(runs, [&]() {
+		std::istringstream is(text);
+		result = qolor::from_csv(is)
+			.select([](std::vector<std::string> const& v) {
+				return std::make_tuple(std::stoi(v[0]), std::stoi(v[1]), std::stod(v[2]), std::stod(v[3]));
+			})
+			.select([](std::tuple<int, int, double, double> const& t) { return std::get<2>(t) + std::get<3>(t); })
+			.sum();
+	});
+
+	double typed = best_of(runs, [&]() {
+		std::istringstream is(text);
+		result = qolor::from_csv<int, int, double, double>(is)
+			.select([](std::tuple<int, int, double, double> const& t) { return std::get<2>(t) + std::get<3>(t); })
+			.sum();
+	});
+
+	double const mb = text.size() / 1e6;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows:       " << rows << " (" << mb << " MB)" << std::endl;
+	std::cout << "stoi/stod   " << strings << " ms (" << mb / strings * 1000 << " MB/s)" << std::endl;
+	std::cout << "typed       " << typed << " ms (" << mb / typed * 1000 << " MB/s)" << std::endl;
+
+	return 0;
+}
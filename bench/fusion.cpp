@@ -0,0 +1,63 @@
+// Abstraction penalty of a where/select/sum query, compared to the
+// equivalent hand-written loop.
+//
+// "pull" iterates the query with a range-for, going through every iterator
+// layer for each element. "push" uses sum(), which runs the whole chain as a
+// single loop over the source.
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile int32_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const n = (argc > 1)? std::stoul(argv[1]) : 10000000;
+	int const runs = 10;
+
+	std::vector<int32_t> values(n);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = int32_t((i * 2654435761u) % 1000);
+
+	double hand = best_of(runs, [&]() {
+		int32_t sum = 0;
+		for (size_t i = 0; i < values.size(); ++i) {
+			int32_t x = values[i];
+			if (x < 500) sum += x * 3;
+		}
+		result = sum;
+	});
+
+	double pull = best_of(runs, [&]() {
+		auto query = qolor::from(values)
+			.where([](int32_t const& x) { return x < 500; })
+			.select([](int32_t const& x) { return x * 3; });
+		int32_t sum = 0;
+		for (auto const& v : query) sum += v;
+		result = sum;
+	});
+
+	double push = best_of(runs, [&]() {
+		result = qolor::from(values)
+			.where([](int32_t const& x) { return x < 500; })
+			.select([](int32_t const& x) { return x * 3; })
+			.sum();
+	});
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "elements:    " << n << std::endl;
+	std::cout << "hand-written " << hand << " ms" << std::endl;
+	std::cout << "qolor pull   " << pull << " ms (x" << pull / hand << ")" << std::endl;
+	std::cout << "qolor push   " << push << " ms (x" << push / hand << ")" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+// Parsing a CSV stream and running an expensive select over its rows, with
+// and without prefetch(), which moves the parse to a separate thread.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile double result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const n = (argc > 1)? std::stoul(argv[1]) : 200000;
+	int const work = (argc > 2)? std::stoi(argv[2]) : 200;
+	int const runs = 5;
+
+	std::ostringstream text;
+	for (size_t i = 0; i < n; ++i)
+		text << i << ",name" << i << "," << (i % 97) * 0.5 << ",some more text in the row\n";
+	std::string const csv = text.str();
+
+	auto compute = [work](std::vector<std::string> const& r) {
+		double x = r[2].size();
+		for (int k = 0; k < work; ++k) x = std::sqrt(x + k);
+		return x;
+	};
+
+	double plain = best_of(runs, [&]() {
+		std::istringstream is(csv);
+		result = qolor::from_csv(is).select(compute).sum();
+	});
+
+	double prefetched = best_of(runs, [&]() {
+		std::istringstream is(csv);
+		result = qolor::from_csv(is).prefetch().select(compute).sum();
+	});
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "rows: " << n << ", work per row: " << work << std::endl;
+	std::cout << "single thread " << plain << " ms" << std::endl;
+	std::cout << "prefetch      " << prefetched << " ms (x" << prefetched / plain << ")" << std::endl;
+
+	return 0;
+}
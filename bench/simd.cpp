@@ -0,0 +1,47 @@
+// Reductions over a contiguous float array: the generic fused loop against the
+// runtime-dispatched simd kernels.
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile float result;
+volatile bool found;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const n = (argc > 1)? std::stoul(argv[1]) : 10000000;
+	int const runs = 10;
+
+	std::vector<float> values(n);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = float((i * 2654435761u) % 1000) / 8;
+
+	typedef float const& ref;
+	auto all = qolor::from(values);
+	// where() with an always true predicate keeps the generic path.
+	auto generic = qolor::from(values).where([](ref) { return true; });
+
+	double sum_generic = best_of(runs, [&]() { result = generic.sum(); });
+	double sum_simd = best_of(runs, [&]() { result = all.sum(); });
+	double max_generic = best_of(runs, [&]() { result = generic.max(); });
+	double max_simd = best_of(runs, [&]() { result = all.max(); });
+	double contains_generic = best_of(runs, [&]() { found = generic.contains(-1.0f); });
+	double contains_simd = best_of(runs, [&]() { found = all.contains(-1.0f); });
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "elements: " << n << ", isa: " << qolor::simd::isa_name(qolor::simd::active_isa()) << std::endl;
+	std::cout << "sum       generic " << sum_generic << " ms, simd " << sum_simd << " ms" << std::endl;
+	std::cout << "max       generic " << max_generic << " ms, simd " << max_simd << " ms" << std::endl;
+	std::cout << "contains  generic " << contains_generic << " ms, simd " << contains_simd << " ms" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+// Loading rows of delimited text into a table of a database file: a command
+// bound and run for every row, in one transaction, compared to insert_into()
+// with its multi-row INSERT and batches.
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <qolor/all.hpp>
+#include <qolor/sqlite3_query_driver.h>
+#include "bench_util.h"
+
+int main(int argc, char* argv[])
+{
+	using namespace qolor::internal;
+	typedef std::tuple<int64_t, qolor::text_view, double> row;
+
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 500000;
+	int const runs = 3;
+	std::string const csv = "bench_sqlite3_insert_into.csv";
+	std::string const path = "bench_sqlite3_insert_into.db";
+
+	{
+		std::ofstream os(csv, std::ios::binary);
+		for (size_t i = 0; i < rows; ++i) os << i << ",name " << i * 31 << ',' << i * 0.25 << '\n';
+	}
+
+	auto fresh = [&]() {
+		std::remove(path.c_str());
+		std::shared_ptr<sqlite3pp::database> db = std::make_shared<sqlite3pp::database>(path.c_str());
+		db->execute("PRAGMA journal_mode = WAL");
+		db->execute("CREATE TABLE t (id INTEGER, name TEXT, value REAL)");
+		return db;
+	};
+
+	double const commands = best_of(runs, [&]() {
+		auto db = fresh();
+		sqlite3pp::transaction xct(*db);
+		sqlite3pp::command cmd(*db, "INSERT INTO t VALUES (?, ?, ?)");
+		qolor::from_csv_file<int64_t, qolor::text_view, double>(csv).for_each([&](row const& r) {
+			cmd.bind(1, std::get<0>(r));
+			cmd.bind(2, std::get<1>(r).data(), int(std::get<1>(r).size()), false);
+			cmd.bind(3, std::get<2>(r));
+			cmd.execute();
+			cmd.reset();
+		});
+		xct.commit();
+	});
+
+	double const insert_into = best_of(runs, [&]() {
+		auto db = fresh();
+		qolor::from_csv_file<int64_t, qolor::text_view, double>(csv).insert_into(*db, "t");
+	});
+
+	std::remove(csv.c_str());
+	std::remove(path.c_str());
+	std::remove((path + "-wal").c_str());
+	std::remove((path + "-shm").c_str());
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< rows << " rows (ms, best of " << runs << ")\n"
+		<< "  command per row  " << commands << "  (" << rows / commands * 1000 << " rows/s)\n"
+		<< "  insert_into      " << insert_into << "  (" << rows / insert_into * 1000 << " rows/s)\n";
+	return 0;
+}
@@ -0,0 +1,88 @@
+// Point reads of a database file from several threads: one connection shared
+// behind a mutex, compared to a database_pool with a connection per thread.
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <qolor/sqlite3_driver.h>
+#include "bench_util.h"
+
+namespace
+{
+
+template <typename Func>
+void on_threads(size_t const& num_threads, Func&& func)
+{
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < num_threads; ++t) threads.emplace_back([&func, t]() { func(t); });
+	for (auto& t : threads) t.join();
+}
+
+int64_t lookup(qolor::internal::sqlite3pp::database& db, int64_t const& id)
+{
+	qolor::internal::sqlite3pp::query qry(db, "SELECT value FROM t WHERE id = ?");
+	qry.bind(1, id);
+	int64_t v = 0;
+	for (auto r = qry.begin(); r != qry.end(); ++r) v += (*r).get<int64_t>(0);
+	return v;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	using namespace qolor::internal;
+
+	size_t const num_threads = (argc > 1)? std::stoul(argv[1]) : std::max(2u, std::thread::hardware_concurrency());
+	size_t const reads = (argc > 2)? std::stoul(argv[2]) : 100000; // per thread
+	int const runs = 3;
+	std::string const path = "bench_sqlite3_pool.db";
+
+	std::remove(path.c_str());
+	{
+		sqlite3pp::database db(path.c_str());
+		db.execute("PRAGMA journal_mode = WAL");
+		db.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, value INTEGER)");
+		db.execute("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 100000) "
+			"INSERT INTO t SELECT i, i * 7 FROM n");
+	}
+
+	sqlite3pp::database shared(path.c_str());
+	shared.set_statement_cache_size(64);
+	std::mutex shared_mutex;
+	double const one_connection = best_of(runs, [&]() {
+		on_threads(num_threads, [&](size_t const& t) {
+			for (size_t i = 0; i < reads; ++i) {
+				std::lock_guard<std::mutex> lock(shared_mutex);
+				lookup(shared, int64_t((i * 7919 + t) % 100000 + 1));
+			}
+		});
+	});
+
+	sqlite3pp::database_pool::options opts;
+	opts.size = num_threads;
+	opts.readonly = true;
+	sqlite3pp::database_pool pool(path.c_str(), opts);
+	double const pooled = best_of(runs, [&]() {
+		on_threads(num_threads, [&](size_t const& t) {
+			auto db = pool.acquire();
+			for (size_t i = 0; i < reads; ++i) lookup(*db, int64_t((i * 7919 + t) % 100000 + 1));
+		});
+	});
+
+	std::remove(path.c_str());
+	std::remove((path + "-wal").c_str());
+	std::remove((path + "-shm").c_str());
+
+	double const total = double(num_threads * reads);
+	std::cout << std::fixed << std::setprecision(1)
+		<< num_threads << " threads x " << reads << " reads (ms, best of " << runs << ")\n"
+		<< "  shared connection  " << one_connection << "  (" << total / one_connection * 1000 << " reads/s)\n"
+		<< "  database_pool      " << pooled << "  (" << total / pooled * 1000 << " reads/s, "
+		<< pool.get_stats().waits << " waits)\n";
+	return 0;
+}
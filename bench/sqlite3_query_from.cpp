@@ -0,0 +1,56 @@
+// Summing a column of a query: query::iterator with get_columns() on every
+// row compared to the tuples of qolor::from<Ts...>(query).
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <qolor/sqlite3_query_driver.h>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile double result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	using namespace qolor::internal;
+
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 1000000;
+	int const runs = 5;
+
+	sqlite3pp::database db(":memory:");
+	db.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER, c REAL)");
+	db.executef("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < %lld) "
+		"INSERT INTO t SELECT i, i %% 7, i * 0.5 FROM n", (long long) rows);
+
+	sqlite3pp::query qry(db, "SELECT id, a, c FROM t");
+
+	double const rows_iterator = best_of(runs, [&]() {
+		qry.reset();
+		double sum = 0;
+		std::tuple<int64_t, int, double> r;
+		for (auto i = qry.begin(); i != qry.end(); ++i) {
+			(*i).get_columns({{0, 1, 2}}, r);
+			if (std::get<1>(r) == 3) sum += std::get<2>(r);
+		}
+		result = sum;
+	});
+
+	double const tuples = best_of(runs, [&]() {
+		typedef std::tuple<int64_t, int, double> row;
+		result = qolor::from<int64_t, int, double>(qry)
+			.where([](row const& r) { return std::get<1>(r) == 3; })
+			.select([](row const& r) { return std::get<2>(r); })
+			.sum();
+	});
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< rows << " rows (ms, best of " << runs << ")\n"
+		<< "  query::iterator  " << rows_iterator << "\n"
+		<< "  from<Ts...>      " << tuples << "\n";
+	return 0;
+}
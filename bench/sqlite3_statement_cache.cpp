@@ -0,0 +1,55 @@
+// The same few statements run over and over: prepared by every query and
+// command, compared to handed out by the statement cache of the database.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <qolor/sqlite3_driver.h>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile int64_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	using namespace qolor::internal;
+
+	size_t const calls = (argc > 1)? std::stoul(argv[1]) : 100000;
+	size_t const num_statements = 40;
+	int const runs = 5;
+
+	sqlite3pp::database db(":memory:");
+	db.execute("CREATE TABLE t (id INTEGER PRIMARY KEY, a INTEGER, b TEXT, c REAL)");
+	db.execute("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < 1000) "
+		"INSERT INTO t SELECT i, i % 7, 'text ' || i, i * 0.5 FROM n");
+
+	std::vector<std::string> sqls;
+	for (size_t i = 0; i < num_statements; ++i)
+		sqls.push_back("SELECT a, b, c FROM t WHERE id = ? AND a >= " + std::to_string(i % 7) + " /* " + std::to_string(i) + " */");
+
+	auto run = [&]() {
+		int64_t sum = 0;
+		for (size_t i = 0; i < calls; ++i) {
+			sqlite3pp::query qry(db, sqls[i % num_statements].c_str());
+			qry.bind(1, int64_t(i % 1000 + 1));
+			for (auto r = qry.begin(); r != qry.end(); ++r) sum += (*r).get<int64_t>(0);
+		}
+		result = sum;
+	};
+
+	double const prepared = best_of(runs, run);
+	db.set_statement_cache_size(64);
+	double const cached = best_of(runs, run);
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< calls << " queries of " << num_statements << " statements (ms, best of " << runs << ")\n"
+		<< "  prepared every time  " << prepared << "\n"
+		<< "  statement cache      " << cached << "  (" << db.get_statement_cache()->hits() << " hits, "
+		<< db.get_statement_cache()->misses() << " misses)\n";
+	return 0;
+}
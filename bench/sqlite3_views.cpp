@@ -0,0 +1,63 @@
+// Scanning a large TEXT column: a new std::string per row, one std::string
+// reused from row to row, and a text_view into the row.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <qolor/sqlite3_driver.h>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile size_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	using namespace qolor::internal;
+
+	size_t const rows = (argc > 1)? std::stoul(argv[1]) : 20000;
+	size_t const width = (argc > 2)? std::stoul(argv[2]) : 4096;
+	int const runs = 5;
+
+	sqlite3pp::database db(":memory:");
+	db.execute("CREATE TABLE docs (id INTEGER PRIMARY KEY, body TEXT)");
+	db.executef("WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < %lld) "
+		"INSERT INTO docs SELECT i, printf('%%.*c', %lld, 'x') FROM n", (long long) rows, (long long) width);
+
+	sqlite3pp::query qry(db, "SELECT body FROM docs");
+
+	double const strings = best_of(runs, [&]() {
+		qry.reset();
+		size_t n = 0;
+		for (auto i = qry.begin(); i != qry.end(); ++i) n += (*i).get<std::string>(0).size();
+		result = n;
+	});
+
+	double const reused = best_of(runs, [&]() {
+		qry.reset();
+		size_t n = 0;
+		std::string body;
+		for (auto i = qry.begin(); i != qry.end(); ++i) {
+			(*i).get(0, body);
+			n += body.size();
+		}
+		result = n;
+	});
+
+	double const views = best_of(runs, [&]() {
+		qry.reset();
+		size_t n = 0;
+		for (auto i = qry.begin(); i != qry.end(); ++i) n += (*i).get<qolor::text_view>(0).size();
+		result = n;
+	});
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< rows << " rows of " << width << " characters (ms, best of " << runs << ")\n"
+		<< "  std::string          " << strings << "\n"
+		<< "  reused std::string   " << reused << "\n"
+		<< "  text_view            " << views << "\n";
+	return 0;
+}
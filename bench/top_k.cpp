@@ -0,0 +1,46 @@
+// order_by().take(k) against sorting the whole input and keeping the first k.
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <qolor/all.hpp>
+#include "bench_util.h"
+
+namespace
+{
+
+volatile uint32_t result;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	size_t const n = (argc > 1)? std::stoul(argv[1]) : 5000000;
+	size_t const k = (argc > 2)? std::stoul(argv[2]) : 100;
+	int const runs = 5;
+
+	std::vector<uint32_t> values(n);
+	for (size_t i = 0; i < n; ++i)
+		values[i] = uint32_t(i * 2654435761u);
+
+	auto key = [](uint32_t const& x) { return x; };
+
+	double full = best_of(runs, [&]() {
+		auto sorted = qolor::from(values).order_by(key).to_vector();
+		result = sorted[k - 1];
+	});
+
+	double top = best_of(runs, [&]() {
+		auto sorted = qolor::from(values).order_by(key).take(k).to_vector();
+		result = sorted[k - 1];
+	});
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "elements:  " << n << ", k: " << k << std::endl;
+	std::cout << "full sort  " << full << " ms" << std::endl;
+	std::cout << "top-k      " << top << " ms (x" << top / full << ")" << std::endl;
+
+	return 0;
+}
@@ -6,6 +6,10 @@
 #include "function_driver.h"
 #include "range_driver.h"
 #include "delimited_text_driver.h"
+#include "mapped_csv_driver.h"
+#include "parallel_csv_driver.h"
+#include "typed_csv_driver.h"
+#include "compressed_csv_driver.h"
 #include "function_driver.h"
 
 #ifndef NDEBUG
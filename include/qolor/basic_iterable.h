@@ -6,6 +6,14 @@
 #include "select_iterator.hpp"
 #include "predicate_iterator.hpp"
 #include "join_iterator.hpp"
+#include "fused_chain.hpp"
+#include "group_by.hpp"
+#include "column_table.hpp"
+#include "columnar_file.h"
+#include "simd_kernels.h"
+#include "size_hint.hpp"
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace qolor
@@ -14,6 +22,24 @@ namespace qolor
 namespace internal
 {
 
+template <typename IteratorType>
+class parallel_iterable;
+
+template <typename IteratorType, typename KeyFunc, bool Descending>
+class ordered_iterable;
+
+template <typename IteratorType>
+class prefetch_state;
+
+template <typename IteratorType>
+class prefetch_iterator;
+
+namespace columnar
+{
+template <typename Value>
+class columnar_sink;
+}
+
 template <typename IteratorType>
 class iterable
 {
@@ -34,23 +60,9 @@ public:
 	static constexpr bool is_writable   = iter_traits::is_writable;
 	static constexpr bool is_bidirectional = iter_traits::is_bidirectional;
 	static constexpr bool is_resetable  = iter_traits::is_resetable;
+	static constexpr bool is_vectorizable = simd::is_vectorizable<IteratorType, value_type>::value;
 
 private:
-	struct count_func
-	{
-		size_t n_;
-		count_func() = delete;
-		count_func(count_func const&) = default;
-		count_func(count_func&&) = default;
-		count_func(size_t const& n) : n_(n) {}
-
-		bool operator() (value_type const&) {
-			if (!n_) return false;
-			--n_;
-			return true;
-		}
-	};
-
 	struct max_advance_other
 	{
 		iterator operator() (iterator b, iterator const& e, size_t c) const {
@@ -62,7 +74,7 @@ private:
 	struct max_advance_bidir
 	{
 		iterator operator() (iterator const& b, iterator const& e, size_t const& c) const {
-			return (e - b < c)? std::move(b + c) : e;
+			return (e - b > difference_type(c))? b + c : e;
 		}
 	};
 
@@ -81,18 +93,110 @@ private:
 	struct get_last_bidir
 	{
 		iterator operator() (iterator const& b, iterator e) const {
-			if (b < e) --e;
-			return std::move(e);
+			if (b != e) --e;
+			return e;
 		}
 	};
 
-	get_last_bidir get_last(std::random_access_iterator_tag);
+	get_last_bidir get_last(std::bidirectional_iterator_tag);
 	get_last_other get_last(...);
 
 	iterator begin_, end_;
 
 	typedef decltype(*begin_) deref_type;
 
+	template <typename Sink>
+	bool push(Sink& sink) const {
+		typedef fused_chain<iterator> chain;
+		return chain::run(begin_, chain::base(begin_), chain::base(end_), sink);
+	}
+
+	typedef std::integral_constant<bool, is_vectorizable> vectorized;
+	typedef std::integral_constant<bool, std::is_same<iterator_category, std::random_access_iterator_tag>::value> random_access;
+
+	// Contiguous sources (is_vectorizable) are handed to the kernels of simd.
+	value_type const* data() const { return std::addressof(*begin_); }
+	size_t size_impl(std::true_type) const { return (begin_ < end_)? (end_ - begin_) : 0; }
+
+	size_t size_impl(std::false_type) const {
+		count_sink s;
+		push(s);
+		return s.n_;
+	}
+
+	value_type sum_impl(std::true_type, std::true_type) const {
+		size_t const n = size_impl(random_access());
+		return n? simd::sum(data(), n) : value_type();
+	}
+
+	// Starting from zero keeps the loop free of the first-element check of
+	// aggregate(), so that it can be vectorized.
+	value_type sum_impl(std::false_type, std::true_type) const {
+		typedef value_type const& ref;
+		return aggregate(value_type(), [](ref a, ref b){ return a + b; });
+	}
+
+	value_type sum_impl(std::false_type, std::false_type) const {
+		typedef value_type const& ref;
+		return aggregate([](ref a, ref b){ return a + b; });
+	}
+
+	value_type min_impl(std::true_type) const {
+		size_t const n = size_impl(random_access());
+		return n? simd::min(data(), n) : value_type();
+	}
+
+	value_type min_impl(std::false_type) const {
+		typedef value_type const& ref;
+		return aggregate([](ref a, ref b) -> value_type { return (b < a)? b : a; });
+	}
+
+	value_type max_impl(std::true_type) const {
+		size_t const n = size_impl(random_access());
+		return n? simd::max(data(), n) : value_type();
+	}
+
+	value_type max_impl(std::false_type) const {
+		typedef value_type const& ref;
+		return aggregate([](ref a, ref b) -> value_type { return (a < b)? b : a; });
+	}
+
+	size_t count_impl(value_type const& value, std::true_type) const {
+		size_t const n = size_impl(random_access());
+		return n? simd::count(data(), n, value) : 0;
+	}
+
+	size_t count_impl(value_type const& value, std::false_type) const {
+		count_value_sink<value_type> s(value);
+		push(s);
+		return s.n_;
+	}
+
+	iterator find_impl(value_type const& value, std::true_type) const {
+		size_t const n = size_impl(random_access());
+		return n? (begin_ + simd::find(data(), n, value)) : end_;
+	}
+
+	iterator find_impl(value_type const& value, std::false_type) const {
+		iterator i(begin_);
+		while (i != end_ && !(*i == value)) ++i;
+		return i;
+	}
+
+	// A source without select/where/take layers is copied in one go.
+	void to_vector_impl(std::vector<value_type>& out, std::true_type) const {
+		out.assign(begin_, end_);
+	}
+
+	// Elements produced by the layers are moved into place, with a single
+	// allocation when the size is known.
+	void to_vector_impl(std::vector<value_type>& out, std::false_type) const {
+		size_estimate const hint = size_hint();
+		if (hint.is_exact()) out.reserve(hint.value);
+		append_sink<std::vector<value_type>> s(out);
+		push(s);
+	}
+
 public:
 	iterable() = delete;
 	iterable(iterable const&) = default;
@@ -108,6 +212,12 @@ public:
 
 	bool empty() const { return begin_ == end_; }
 
+	// Number of elements as far as it is known without iterating: exact
+	// through select, an upper bound through where and take_while.
+	size_estimate size_hint() const {
+		return size_hint_of<iterator>::get(begin_, end_);
+	}
+
 	template <typename F>
 	iterable<select_iterator<iterator, F> > select(F&& f) {
 		using iter_t = select_iterator<iterator, F>;
@@ -121,7 +231,7 @@ public:
 		static_assert(utils::is_predicate<ftype, value_type const&>(), "Parameter is not an appropriate functional");
 		typedef where_iterator<iterator, ftype> iter_t;
 		iter_t b(begin_, end_, std::forward<F>(f));
-		iter_t e(end_, end_, std::forward<F>(f));
+		iter_t e(end_, utils::generic_end_iterator());
 		return iterable<iter_t>(std::move(b), std::move(e));
 	}
 
@@ -131,7 +241,7 @@ public:
 		static_assert(utils::is_predicate<ftype, value_type const&>(), "Parameter is not an appropriate functional");
 		typedef while_iterator<iterator, ftype> iter_t;
 		iter_t b(begin_, end_, std::forward<F>(f));
-		iter_t e(end_, end_, std::forward<F>(f));
+		iter_t e(end_, utils::generic_end_iterator());
 		return iterable<iter_t>(std::move(b), std::move(e));
 	}
 
@@ -143,8 +253,8 @@ public:
 		return iterable(std::move(i), end_);
 	}
 
-	iterable<while_iterator<iterator, count_func> > take(size_t const& count) {
-		return std::move(take_while(count_func(count)));
+	iterable<while_iterator<iterator, count_predicate<value_type>> > take(size_t const& count) {
+		return take_while(count_predicate<value_type>(count));
 	}
 
 	iterable<iterator> skip(size_t const& count) {
@@ -155,14 +265,14 @@ public:
 
 	typename std::enable_if<is_readable, deref_type>::type
 	first() {
-		return std::forward<value_type>(*begin_);
+		return *begin_;
 	}
 
 	typename std::enable_if<is_readable, deref_type>::type
 	last() {
 		typedef decltype(get_last(std::declval<iterator_category>())) getlast_t;
 		static const getlast_t getlast;
-		return std::forward<value_type>(*(getlast(begin_, end_)));
+		return *(getlast(begin_, end_));
 	}
 
 	template<typename J, typename P>
@@ -175,6 +285,17 @@ public:
 		return rtype(begin_, end_, std::move(o.begin()), std::move(o.end()), std::forward<P>(pred));
 	}
 
+	template<typename J, typename K1, typename K2>
+	typename std::enable_if<
+		is_readable && iterable<J>::is_readable
+		,iterable<hash_join_iterator<iterator, J, K1, K2>>
+	>::type
+	join_on(iterable<J> const& o, K1&& key1, K2&& key2) {
+		using iter_t = hash_join_iterator<iterator, J, K1, K2>;
+		iter_t b(begin_, end_, o.begin(), o.end(), std::forward<K1>(key1), std::forward<K2>(key2));
+		return iterable<iter_t>(std::move(b), iter_t());
+	}
+
 	template <typename Predicate>
 	typename std::enable_if<is_readable,bool>::type
 	contains(value_type const& value, Predicate&& pred) {
@@ -192,42 +313,149 @@ public:
 	}
 
 	typename std::enable_if<is_readable,bool>::type
-	contains(value_type const& value) {
-		for (auto& v : *this)
-			if (value == v) return true;
-		return false;
+	contains(value_type const& value) const {
+		if (is_vectorizable) return find(value) != end_;
+		contains_sink<value_type> s(value);
+		push(s);
+		return s.found_;
 	}
 
-	typename std::enable_if<is_readable,bool>::type
-	contains(value_type const& value) const {
-		for (auto const& v : *this)
-			if (value == v) return true;
-		return false;
+	// Iterator to the first element equal to value, or end().
+	typename std::enable_if<is_readable,iterator>::type
+	find(value_type const& value) const {
+		return find_impl(value, vectorized());
+	}
+
+	// Number of elements. O(1) for random access sources.
+	size_t count() const {
+		return size_impl(random_access());
+	}
+
+	typename std::enable_if<is_readable,size_t>::type
+	count(value_type const& value) const {
+		return count_impl(value, vectorized());
+	}
+
+	// Calls f for every element. The whole select/where/take chain runs as a
+	// single loop over the source.
+	template <typename F>
+	typename std::enable_if<is_readable,void>::type
+	for_each(F&& f) const {
+		for_each_sink<F> s(f);
+		push(s);
 	}
 
 	template <typename F>
 	typename std::enable_if<is_readable,value_type>::type
-	aggregate(F&& f) {
+	aggregate(F&& f) const {
 		static_assert(std::is_trivial<value_type>::value || std::is_default_constructible<value_type>::value,
 			"value_type must be default constructible.");
-		if (begin_ == end_) return value_type();
-		iterator i(begin_);
-		value_type acc(*i);
-		while ((++i) != end_) acc = f(acc, *i);
-		return std::move(acc);
+		aggregate_sink<value_type, F> s(f);
+		push(s);
+		return std::move(s.acc_);
+	}
+
+	template <typename A, typename F>
+	typename std::enable_if<is_readable,typename std::decay<A>::type>::type
+	aggregate(A&& seed, F&& f) const {
+		fold_sink<typename std::decay<A>::type, F> s(f, std::forward<A>(seed));
+		push(s);
+		return std::move(s.acc_);
 	}
 
 	typename std::enable_if<is_readable,value_type>::type
-	sum() {
-		typedef value_type const& ref;
-		return aggregate([](ref a, ref b){ return a + b; });
+	sum() const {
+		return sum_impl(vectorized(), std::is_arithmetic<value_type>());
+	}
+
+	// Smallest and largest element, or value_type() for empty sources.
+	typename std::enable_if<is_readable,value_type>::type
+	min() const {
+		return min_impl(vectorized());
+	}
+
+	typename std::enable_if<is_readable,value_type>::type
+	max() const {
+		return max_impl(vectorized());
 	}
 
 	typename std::enable_if<is_readable,std::vector<value_type>>::type
-	to_vector() {
+	to_vector() const {
+		typedef std::is_same<typename fused_chain<iterator>::base_iterator, iterator> is_source;
 		std::vector<value_type> ret;
-		for (auto& v : *this) ret.push_back(v);
-		return std::move(ret);
+		to_vector_impl(ret, is_source());
+		return ret;
+	}
+
+	// Stores the elements (tuples or pairs) by column, converted to Ts if
+	// given; see column_table. Later scans of a few of the columns read those
+	// only.
+	template <typename... Ts>
+	typename column_table_of<value_type, Ts...>::type
+	to_columns() const {
+		typedef typename column_table_of<value_type, Ts...>::type table_type;
+		table_type ret;
+		size_estimate const hint = size_hint();
+		if (hint.is_exact()) ret.reserve(hint.value);
+		append_sink<table_type> s(ret);
+		push(s);
+		return ret;
+	}
+
+	// Writes the elements (tuples or pairs) to a columnar file at path, in
+	// blocks of rows_per_block rows; see from_columnar_file(). names are
+	// those of the columns, for columns by name. Throws std::system_error if
+	// the file cannot be written.
+	void to_columnar_file(std::string const& path, std::vector<std::string> const& names = std::vector<std::string>(),
+		size_t const& rows_per_block = columnar::default_rows_per_block) const {
+		columnar::columnar_sink<value_type> s(path, names, rows_per_block);
+		push(s);
+		s.finish();
+	}
+
+	// Inserts the elements (tuples, pairs or single values) as rows of table
+	// in db, a sqlite3pp::database (see sqlite3_query_driver.h), into columns
+	// (all of them, in order, if none), and commits them every batch_rows
+	// rows (0 for all of them at once). Returns the number of rows.
+	template <typename Database>
+	size_t insert_into(Database& db, std::string const& table,
+		std::vector<std::string> const& columns = std::vector<std::string>(), size_t const& batch_rows = 100000) const {
+		auto s = make_insert_sink(db, table, columns, batch_rows, static_cast<value_type const*>(nullptr));
+		push(s);
+		s.finish();
+		return s.rows();
+	}
+
+	// Groups the elements by key_fn(element) in a single pass and folds every
+	// group with each of aggs (see qolor::agg). Plain binary functionals work
+	// like in aggregate(). Groups come out in the order of their first element.
+	template <typename K, typename... A>
+	typename group_by_traits<value_type, K, A...>::map_type
+	group_by(K&& key_fn, A&&... aggs) const {
+		typedef group_by_traits<value_type, K, A...> traits;
+		typedef typename traits::map_type map_type;
+		typedef typename traits::aggregators aggs_type;
+		typedef typename traits::key_func key_func;
+
+		map_type ret;
+		key_func k(std::forward<K>(key_fn));
+		aggs_type a(typename aggregator_of<A>::type(std::forward<A>(aggs))...);
+		group_sink<map_type, key_func, aggs_type> s(ret, k, a);
+		push(s);
+		return ret;
+	}
+
+	// Sorts the elements by key_fn(element), keeping the source order of equal
+	// keys. Followed by take(k), only the first k elements are kept while
+	// scanning the source, instead of sorting all of it.
+	template <typename K>
+	ordered_iterable<iterator, typename std::decay<K>::type, false> order_by(K&& key_fn) const {
+		return ordered_iterable<iterator, typename std::decay<K>::type, false>(*this, std::forward<K>(key_fn));
+	}
+
+	template <typename K>
+	ordered_iterable<iterator, typename std::decay<K>::type, true> order_by_descending(K&& key_fn) const {
+		return ordered_iterable<iterator, typename std::decay<K>::type, true>(*this, std::forward<K>(key_fn));
 	}
 
 	template <typename I2>
@@ -235,6 +463,20 @@ public:
 	update(I2& out) {
 		return std::copy(begin_, end_, out);
 	}
+
+	// Runs the query so far on a separate thread, which stays up to capacity
+	// elements ahead of the rest of the query.
+	iterable<prefetch_iterator<iterator>> prefetch(size_t const& capacity = 4096) const {
+		typedef prefetch_iterator<iterator> iter_t;
+		auto state = std::make_shared<prefetch_state<iterator>>(*this, capacity);
+		return iterable<iter_t>(iter_t(state), iter_t());
+	}
+
+	// Runs the rest of the query on num_threads threads (0 for one per core).
+	// The source must be random access and the query must not use take().
+	parallel_iterable<iterator> parallel(size_t const& num_threads = 0) const {
+		return parallel_iterable<iterator>(*this, num_threads);
+	}
 };
 
 
@@ -283,4 +525,9 @@ auto from(IterableType&& c) -> typename std::enable_if<
 
 } // namespace qolor
 
+#include "parallel_iterable.hpp"
+#include "ordered_iterable.hpp"
+#include "prefetch_iterator.hpp"
+#include "columnar_driver.h"
+
 #endif // QOLOR_BASIC_ITERABLE_H__
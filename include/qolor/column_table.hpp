@@ -0,0 +1,214 @@
+#ifndef QOLOR_COLUMN_TABLE_HPP__
+#define QOLOR_COLUMN_TABLE_HPP__
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+template <typename IteratorType>
+class iterable;
+
+template <size_t N>
+struct column_apply
+{
+	template <typename Columns, typename Tuple>
+	static void push_back(Columns& cols, Tuple&& t) {
+		column_apply<N - 1>::push_back(cols, std::forward<Tuple>(t));
+		std::get<N - 1>(cols).push_back(std::get<N - 1>(std::forward<Tuple>(t)));
+	}
+
+	template <typename Columns>
+	static void reserve(Columns& cols, size_t const& n) {
+		column_apply<N - 1>::reserve(cols, n);
+		std::get<N - 1>(cols).reserve(n);
+	}
+
+	template <typename Columns>
+	static void clear(Columns& cols) {
+		column_apply<N - 1>::clear(cols);
+		std::get<N - 1>(cols).clear();
+	}
+};
+
+template <>
+struct column_apply<0>
+{
+	template <typename Columns, typename Tuple>
+	static void push_back(Columns&, Tuple&&) {}
+
+	template <typename Columns>
+	static void reserve(Columns&, size_t const&) {}
+
+	template <typename Columns>
+	static void clear(Columns&) {}
+};
+
+
+// Rows of the columns Is of a table, put together as tuples when they are
+// read. Tables do not change while they are scanned.
+//
+// This is a proxy iterator: it moves like a random access iterator (which is
+// what the iterables use its category for, to skip and count rows without
+// reading them), but its reference is the tuple by value, so it is not a
+// standard random access, or even forward, iterator. Standard algorithms
+// that need one (e.g. std::sort, std::reverse_iterator) must not be given it.
+template <typename Table, size_t... Is>
+class column_iterator
+{
+public:
+	typedef std::tuple<typename Table::template column_type<Is>...> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef value_type reference;
+	typedef void pointer;
+	typedef std::random_access_iterator_tag iterator_category;
+
+private:
+	Table const* table_;
+	size_t i_;
+
+public:
+	column_iterator() : table_(nullptr), i_(0) {}
+	column_iterator(Table const& table, size_t const& i) : table_(&table), i_(i) {}
+
+	column_iterator& operator++() { ++i_; return *this; }
+	column_iterator& operator--() { --i_; return *this; }
+	column_iterator operator++(int) { column_iterator i(*this); ++i_; return i; }
+	column_iterator operator--(int) { column_iterator i(*this); --i_; return i; }
+
+	column_iterator& operator+=(difference_type const& n) { i_ += n; return *this; }
+	column_iterator& operator-=(difference_type const& n) { i_ -= n; return *this; }
+	column_iterator operator+(difference_type const& n) const { return column_iterator(*table_, i_ + n); }
+	column_iterator operator-(difference_type const& n) const { return column_iterator(*table_, i_ - n); }
+	difference_type operator-(column_iterator const& o) const { return difference_type(i_) - difference_type(o.i_); }
+
+	bool operator==(column_iterator const& o) const { return i_ == o.i_; }
+	bool operator!=(column_iterator const& o) const { return i_ != o.i_; }
+	bool operator< (column_iterator const& o) const { return i_ <  o.i_; }
+	bool operator> (column_iterator const& o) const { return i_ >  o.i_; }
+	bool operator<=(column_iterator const& o) const { return i_ <= o.i_; }
+	bool operator>=(column_iterator const& o) const { return i_ >= o.i_; }
+
+	reference operator*() const { return value_type(table_->template column<Is>()[i_]...); }
+	reference operator[](difference_type const& n) const { return *(*this + n); }
+};
+
+template <typename Table, size_t N, size_t... Is>
+struct all_columns_iterator
+{
+	typedef typename all_columns_iterator<Table, N - 1, N - 1, Is...>::type type;
+};
+
+template <typename Table, size_t... Is>
+struct all_columns_iterator<Table, 0, Is...>
+{
+	typedef column_iterator<Table, Is...> type;
+};
+
+} // namespace internal
+
+
+// Tuples of Ts stored by column: every element of the tuples is in a vector
+// of its own, so that scans of some of the columns (see from()) read those
+// only, from contiguous memory. Made by iterable::to_columns().
+template <typename... Ts>
+class column_table
+{
+	static_assert(sizeof...(Ts) > 0, "column_table needs at least one column.");
+
+public:
+	typedef std::tuple<Ts...> value_type;
+	// A proxy iterator that makes the tuples as they are read; see
+	// internal::column_iterator.
+	typedef typename internal::all_columns_iterator<column_table, sizeof...(Ts)>::type const_iterator;
+	typedef const_iterator iterator;
+
+	template <size_t I>
+	using column_type = typename std::tuple_element<I, value_type>::type;
+
+private:
+	typedef std::tuple<std::vector<Ts>...> columns_type;
+	typedef internal::column_apply<sizeof...(Ts)> apply;
+
+	columns_type columns_;
+
+public:
+	size_t size() const { return std::get<0>(columns_).size(); }
+	bool empty() const { return size() == 0; }
+
+	void reserve(size_t const& n) { apply::reserve(columns_, n); }
+	void clear() { apply::clear(columns_); }
+
+	// Appends a row: a tuple (or pair) whose elements convert to Ts.
+	template <typename Tuple>
+	void push_back(Tuple&& row) { apply::push_back(columns_, std::forward<Tuple>(row)); }
+
+	template <size_t I>
+	std::vector<column_type<I>> const& column() const { return std::get<I>(columns_); }
+
+	template <size_t I>
+	std::vector<column_type<I>>& column() { return std::get<I>(columns_); }
+
+	value_type operator[](size_t const& i) const { return *(begin() + i); }
+
+	const_iterator begin() const { return const_iterator(*this, 0); }
+	const_iterator end() const { return const_iterator(*this, size()); }
+};
+
+namespace internal
+{
+
+// The table of to_columns(): Ts if any, or the elements of Value, which is a
+// tuple or a pair.
+template <typename Value, typename... Ts>
+struct column_table_of
+{
+	typedef column_table<Ts...> type;
+};
+
+template <typename... Us>
+struct column_table_of<std::tuple<Us...>>
+{
+	typedef column_table<Us...> type;
+};
+
+template <typename A, typename B>
+struct column_table_of<std::pair<A, B>>
+{
+	typedef column_table<A, B> type;
+};
+
+} // namespace internal
+
+
+// Scans column I of a table, as a contiguous array: sum(), min(), max(),
+// count() and find() use the vectorized kernels of simd.
+template <size_t I, typename... Ts>
+internal::iterable<typename column_table<Ts...>::template column_type<I> const*>
+from(column_table<Ts...> const& table)
+{
+	typedef typename column_table<Ts...>::template column_type<I> const* iter_t;
+	auto const& column = table.template column<I>();
+	return internal::iterable<iter_t>(column.data(), column.data() + column.size());
+}
+
+// Scans columns I, J, Is... of a table, as tuples of these only.
+template <size_t I, size_t J, size_t... Is, typename... Ts>
+internal::iterable<internal::column_iterator<column_table<Ts...>, I, J, Is...>>
+from(column_table<Ts...> const& table)
+{
+	typedef internal::column_iterator<column_table<Ts...>, I, J, Is...> iter_t;
+	return internal::iterable<iter_t>(iter_t(table, 0), iter_t(table, table.size()));
+}
+
+} // namespace qolor
+
+#endif // QOLOR_COLUMN_TABLE_HPP__
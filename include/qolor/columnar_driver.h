@@ -0,0 +1,341 @@
+#ifndef QOLOR_COLUMNAR_DRIVER_H__
+#define QOLOR_COLUMNAR_DRIVER_H__
+
+#include "basic_iterable.h"
+#include "columnar_file.h"
+#include "csv_columns.h"
+#include "field_filter.h"
+#include "text_view.hpp"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace columnar
+{
+
+// The type of the column of values of type T.
+template <typename T, typename Enable = void>
+struct type_of;
+
+template <typename T>
+struct type_of<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+	static constexpr type_code value =
+		(sizeof(T) == 1)? (std::is_signed<T>::value? type_code::int8 : type_code::uint8) :
+		(sizeof(T) == 2)? (std::is_signed<T>::value? type_code::int16 : type_code::uint16) :
+		(sizeof(T) == 4)? (std::is_signed<T>::value? type_code::int32 : type_code::uint32) :
+		(std::is_signed<T>::value? type_code::int64 : type_code::uint64);
+};
+
+template <> struct type_of<bool> { static constexpr type_code value = type_code::boolean; };
+template <> struct type_of<float> { static constexpr type_code value = type_code::float32; };
+template <> struct type_of<double> { static constexpr type_code value = type_code::float64; };
+template <> struct type_of<std::string> { static constexpr type_code value = type_code::string; };
+template <> struct type_of<text_view> { static constexpr type_code value = type_code::string; };
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+append(column_buffer& c, T const& v)
+{
+	c.data.append(reinterpret_cast<char const*>(&v), sizeof(T));
+	double const d = double(v);
+	if (d < c.min) c.min = d; // NaN is neither
+	if (d > c.max) c.max = d;
+}
+
+inline void append(column_buffer& c, text_view const& v)
+{
+	c.data.append(v.data(), v.size());
+	c.offsets.push_back(c.data.size());
+}
+
+inline void append(column_buffer& c, std::string const& v) { append(c, text_view(v)); }
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+read(char const* data, size_t const&, size_t const& row, T*)
+{
+	return reinterpret_cast<T const*>(data)[row];
+}
+
+inline text_view read(char const* data, size_t const& rows, size_t const& row, text_view*)
+{
+	uint64_t const* offsets = reinterpret_cast<uint64_t const*>(data);
+	char const* chars = data + (rows + 1) * sizeof(uint64_t);
+	return text_view(chars + offsets[row], size_t(offsets[row + 1] - offsets[row]));
+}
+
+inline std::string read(char const* data, size_t const& rows, size_t const& row, std::string*)
+{
+	return read(data, rows, row, static_cast<text_view*>(nullptr)).str();
+}
+
+// A value of a numeric column as a double, for filters.
+inline double read_double(type_code const& type, char const* data, size_t const& row)
+{
+	switch (type) {
+	case type_code::int8: return read(data, 0, row, static_cast<int8_t*>(nullptr));
+	case type_code::uint8: return read(data, 0, row, static_cast<uint8_t*>(nullptr));
+	case type_code::int16: return read(data, 0, row, static_cast<int16_t*>(nullptr));
+	case type_code::uint16: return read(data, 0, row, static_cast<uint16_t*>(nullptr));
+	case type_code::int32: return read(data, 0, row, static_cast<int32_t*>(nullptr));
+	case type_code::uint32: return read(data, 0, row, static_cast<uint32_t*>(nullptr));
+	case type_code::int64: return double(read(data, 0, row, static_cast<int64_t*>(nullptr)));
+	case type_code::uint64: return double(read(data, 0, row, static_cast<uint64_t*>(nullptr)));
+	case type_code::float32: return read(data, 0, row, static_cast<float*>(nullptr));
+	case type_code::float64: return read(data, 0, row, static_cast<double*>(nullptr));
+	case type_code::boolean: return read(data, 0, row, static_cast<bool*>(nullptr));
+	case type_code::string: break;
+	}
+	return std::nan("");
+}
+
+template <typename Tuple, size_t N = std::tuple_size<Tuple>::value>
+struct tuple_columns
+{
+	typedef typename std::decay<typename std::tuple_element<N - 1, Tuple>::type>::type element_type;
+
+	static void types(std::vector<type_code>& out) {
+		tuple_columns<Tuple, N - 1>::types(out);
+		out.push_back(type_code(type_of<element_type>::value));
+	}
+
+	static void append(std::vector<column_buffer>& columns, Tuple const& t) {
+		tuple_columns<Tuple, N - 1>::append(columns, t);
+		columnar::append(columns[N - 1], std::get<N - 1>(t));
+	}
+
+	template <typename Data>
+	static void read(Tuple& t, Data const& data, size_t const& rows, size_t const& row) {
+		tuple_columns<Tuple, N - 1>::read(t, data, rows, row);
+		std::get<N - 1>(t) = columnar::read(data[N - 1], rows, row, static_cast<element_type*>(nullptr));
+	}
+};
+
+template <typename Tuple>
+struct tuple_columns<Tuple, 0>
+{
+	static void types(std::vector<type_code>&) {}
+	static void append(std::vector<column_buffer>&, Tuple const&) {}
+
+	template <typename Data>
+	static void read(Tuple&, Data const&, size_t const&, size_t const&) {}
+};
+
+// Writes the elements of a query, tuples or pairs, one block of rows at a
+// time.
+template <typename Value>
+class columnar_sink
+{
+private:
+	typedef tuple_columns<Value> columns_type;
+
+	std::vector<column_buffer> columns_;
+	file_writer writer_;
+	size_t rows_per_block_;
+	size_t rows_;
+
+	static std::vector<type_code> types() {
+		std::vector<type_code> ret;
+		columns_type::types(ret);
+		return ret;
+	}
+
+public:
+	columnar_sink(std::string const& path, std::vector<std::string> const& names, size_t const& rows_per_block)
+		: columns_(std::tuple_size<Value>::value), writer_(path, types(), names, rows_per_block),
+		rows_per_block_(rows_per_block? rows_per_block : 1), rows_(0) {
+		std::vector<type_code> const t = types();
+		for (size_t i = 0; i < t.size(); ++i) {
+			columns_[i].type = t[i];
+			columns_[i].clear();
+		}
+	}
+
+	template <typename T>
+	bool operator()(T const& v) {
+		columns_type::append(columns_, v);
+		if (++rows_ == rows_per_block_) {
+			writer_.write_block(rows_, columns_);
+			rows_ = 0;
+		}
+		return true;
+	}
+
+	void finish() {
+		if (rows_) writer_.write_block(rows_, columns_);
+		writer_.finish();
+	}
+};
+
+struct columnar_source
+{
+	file_reader file;
+	std::vector<size_t> columns;             // in the file, of the values read
+	std::vector<field_filter::range> ranges; // with columns in the file
+
+	explicit columnar_source(std::string const& path) : file(path) {}
+};
+
+// Reads the blocks of the columns of a file that the source reads, skipping
+// the blocks whose min and max are out of the ranges of the source, and the
+// rows that are out of them.
+template <typename... Ts>
+class columnar_iterator
+{
+public:
+	typedef std::tuple<Ts...> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef value_type reference;
+	typedef void pointer;
+	typedef std::forward_iterator_tag iterator_category;
+
+private:
+	typedef tuple_columns<value_type> columns_type;
+
+	std::shared_ptr<columnar_source const> src_;
+	size_t block_;
+	size_t row_;
+	size_t rows_; // of the block
+	std::array<char const*, sizeof...(Ts)> data_;
+	std::vector<char const*> range_data_;
+
+	bool pruned(size_t const& block) const {
+		for (auto const& r : src_->ranges) {
+			block_entry const& e = src_->file.entry(block, r.column);
+			if (!(e.max >= r.lo && e.min <= r.hi)) return true;
+		}
+		return false;
+	}
+
+	bool matches(size_t const& row) const {
+		for (size_t i = 0; i < src_->ranges.size(); ++i) {
+			auto const& r = src_->ranges[i];
+			double const v = read_double(src_->file.types()[r.column], range_data_[i], row);
+			if (!(v >= r.lo && v <= r.hi)) return false;
+		}
+		return true;
+	}
+
+	void enter_block() {
+		file_reader const& f = src_->file;
+		row_ = rows_ = 0;
+		while (block_ < f.num_blocks() && pruned(block_)) ++block_;
+		if (block_ >= f.num_blocks()) return;
+
+		rows_ = f.rows_in_block(block_);
+		for (size_t i = 0; i < data_.size(); ++i) {
+			size_t const c = src_->columns[i];
+			if (f.types()[c] == type_code::string) f.check_strings(block_, c);
+			data_[i] = f.data(block_, c);
+		}
+		range_data_.clear();
+		for (auto const& r : src_->ranges) range_data_.push_back(f.data(block_, r.column));
+	}
+
+	// Moves to the first row from the current one that is in the ranges.
+	void settle() {
+		for (;;) {
+			if (row_ == rows_) {
+				if (block_ >= src_->file.num_blocks()) return;
+				++block_;
+				enter_block();
+				continue;
+			}
+			if (range_data_.empty() || matches(row_)) return;
+			++row_;
+		}
+	}
+
+public:
+	columnar_iterator() : block_(0), row_(0), rows_(0) {}
+
+	// The first row, or the end if at_end.
+	columnar_iterator(std::shared_ptr<columnar_source const> const& src, bool const& at_end)
+		: src_(src), block_(at_end? src->file.num_blocks() : 0), row_(0), rows_(0) {
+		if (!at_end) {
+			enter_block();
+			settle();
+		}
+	}
+
+	columnar_iterator& operator++() {
+		++row_;
+		settle();
+		return *this;
+	}
+
+	columnar_iterator operator++(int) {
+		columnar_iterator i(*this);
+		++*this;
+		return i;
+	}
+
+	reference operator*() const {
+		value_type t;
+		columns_type::read(t, data_, rows_, row_);
+		return t;
+	}
+
+	bool operator==(columnar_iterator const& o) const { return block_ == o.block_ && row_ == o.row_; }
+	bool operator!=(columnar_iterator const& o) const { return !(*this == o); }
+};
+
+} // namespace columnar
+
+} // namespace internal
+
+
+// Reads a file written by iterable::to_columnar_file(). Only the given
+// columns (all of them by default) are read, as Ts, which must be the types
+// they were written as (text_view for strings points into the mapping of the
+// file, valid while the query is). The file is mapped, so restarts only read
+// what they touch. Ranges of filter (its between() conditions, on columns of
+// the file) skip the blocks whose min and max are out of them, without
+// reading them, and the rows out of them. Throws std::invalid_argument if the
+// columns or the types do not match the file.
+template <typename T, typename... Ts>
+internal::iterable<internal::columnar::columnar_iterator<T, Ts...>>
+from_columnar_file(std::string const& path, columns const& cols = columns(), field_filter const& filter = field_filter())
+{
+	using namespace internal::columnar;
+	typedef columnar_iterator<T, Ts...> iter_t;
+
+	auto src = std::make_shared<columnar_source>(path);
+	file_reader const& f = src->file;
+	if (cols.size()) src->columns = cols.resolve(f.names());
+	else for (size_t i = 0; i < f.num_columns(); ++i) src->columns.push_back(i);
+	src->ranges = filter.ranges();
+
+	type_code const types[] = { type_of<T>::value, type_of<Ts>::value... };
+	if (src->columns.size() != sizeof(types) / sizeof(types[0]))
+		throw std::invalid_argument("qolor: " + std::to_string(src->columns.size()) + " columns of " + path
+			+ " read as " + std::to_string(sizeof(types) / sizeof(types[0])) + " types");
+	for (size_t i = 0; i < src->columns.size(); ++i) {
+		size_t const c = src->columns[i];
+		if (c >= f.num_columns() || f.types()[c] != types[i])
+			throw std::invalid_argument("qolor: column " + std::to_string(c) + " of " + path + " is not of the type read");
+	}
+	for (auto const& r : src->ranges)
+		if (r.column >= f.num_columns() || f.types()[r.column] == type_code::string)
+			throw std::invalid_argument("qolor: column " + std::to_string(r.column) + " of " + path + " is not numeric");
+
+	std::shared_ptr<columnar_source const> const s(src);
+	return internal::iterable<iter_t>(iter_t(s, false), iter_t(s, true));
+}
+
+} // namespace qolor
+
+#endif // QOLOR_COLUMNAR_DRIVER_H__
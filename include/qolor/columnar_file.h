@@ -0,0 +1,138 @@
+#ifndef QOLOR_COLUMNAR_FILE_H__
+#define QOLOR_COLUMNAR_FILE_H__
+
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace columnar
+{
+
+// The columnar file format, in the byte order of the machine:
+//
+//     header     "QOLORCOL", version, number of columns, rows, rows per block,
+//                blocks and offset of the directory
+//     blocks     the data of every column of the first block, then of the
+//                second one, ..., each starting at a multiple of 8 bytes
+//     directory  type of every column, their names, and the offset, size, min
+//                and max of every column of every block
+//
+// A block of a numeric column is an array of its values; a block of a string
+// column is an array of rows + 1 uint64_t offsets into the characters that
+// follow it. min and max are those of the values of the block as doubles (NaN
+// values left out), for numeric columns only.
+enum class type_code : uint32_t
+{
+	int8 = 1, uint8, int16, uint16, int32, uint32, int64, uint64,
+	float32, float64, boolean, string
+};
+
+static constexpr size_t default_rows_per_block = 64 * 1024;
+
+// Bytes of a value of a numeric column; 0 for strings.
+size_t value_size(type_code const& type);
+
+struct block_entry
+{
+	uint64_t offset;
+	uint64_t size;
+	double min;
+	double max;
+};
+
+// The values of a column for the block being written.
+struct column_buffer
+{
+	type_code type;
+	std::string data;              // values, or characters of strings
+	std::vector<uint64_t> offsets; // of strings, plus the end of the last one
+	double min, max;
+
+	void clear();
+};
+
+// Writes blocks of columns to a new file. Throws std::system_error if the
+// file cannot be written.
+class file_writer
+{
+private:
+	std::ofstream os_;
+	std::string path_;
+	std::vector<type_code> types_;
+	std::vector<std::string> names_;
+	uint64_t rows_per_block_;
+	uint64_t num_rows_;
+	std::vector<block_entry> blocks_;
+
+	void write(void const* data, size_t const& size);
+	void pad();
+
+public:
+	file_writer(std::string const& path, std::vector<type_code> const& types,
+		std::vector<std::string> const& names, size_t const& rows_per_block);
+
+	// Writes rows of the columns, and clears them.
+	void write_block(size_t const& rows, std::vector<column_buffer>& columns);
+
+	// Writes the directory; nothing can be written afterwards.
+	void finish();
+};
+
+// Reads the header and the directory of a file, and maps the rest of it,
+// which is paged in as it is read. Throws std::system_error if the file
+// cannot be read, and std::runtime_error if it is not a columnar file.
+class file_reader
+{
+private:
+	std::shared_ptr<utils::mapped_file const> file_;
+	std::vector<type_code> types_;
+	std::vector<std::string> names_;
+	uint64_t num_rows_;
+	uint64_t rows_per_block_;
+	uint64_t num_blocks_;
+	block_entry const* blocks_;
+
+public:
+	explicit file_reader(std::string const& path);
+
+	size_t num_columns() const { return types_.size(); }
+	size_t num_rows() const { return size_t(num_rows_); }
+	size_t num_blocks() const { return size_t(num_blocks_); }
+	std::vector<type_code> const& types() const { return types_; }
+	std::vector<std::string> const& names() const { return names_; }
+
+	size_t rows_in_block(size_t const& block) const {
+		size_t const b = block * size_t(rows_per_block_);
+		return (num_rows() - b < rows_per_block_)? num_rows() - b : size_t(rows_per_block_);
+	}
+
+	block_entry const& entry(size_t const& block, size_t const& column) const {
+		return blocks_[block * types_.size() + column];
+	}
+
+	char const* data(size_t const& block, size_t const& column) const {
+		return file_->data() + entry(block, column).offset;
+	}
+
+	// Checks that the offsets of a block of strings are within the block,
+	// which is only read when the block is.
+	void check_strings(size_t const& block, size_t const& column) const;
+};
+
+} // namespace columnar
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_COLUMNAR_FILE_H__
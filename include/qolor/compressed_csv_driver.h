@@ -0,0 +1,56 @@
+#ifndef QOLOR_COMPRESSED_CSV_DRIVER_H__
+#define QOLOR_COMPRESSED_CSV_DRIVER_H__
+
+#include "compressed_file.h"
+#include "typed_csv_driver.h"
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace qolor
+{
+
+// Reads a gzip-compressed file (.csv.gz) as delimited text, without
+// decompressing it to disk first: the file is decompressed on a thread of its
+// own while the rows are parsed, as in from_csv_file. Files that are not
+// compressed are read as they are. Throws std::system_error if the file
+// cannot be opened; corrupt data throws std::runtime_error when it is read.
+// Like from_csv, a row is a line.
+inline internal::iterable<internal::csv::stream_csv_iterator>
+from_csv_compressed(std::string const& path, columns const& cols, char const& field_sep = ',')
+{
+	typedef internal::csv::stream_csv_iterator iter_t;
+	std::shared_ptr<std::istream> is = std::make_shared<utils::compressed_istream>(path);
+	iter_t begin(is, field_sep);
+	if (cols.by_name()) ++begin; // the header
+	begin.project(cols.resolve(*begin));
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(*is, utils::generic_end_iterator()));
+}
+
+inline internal::iterable<internal::csv::stream_csv_iterator>
+from_csv_compressed(std::string const& path, char const& field_sep = ',')
+{
+	return from_csv_compressed(path, columns(), field_sep);
+}
+
+// Reads the rows into tuples of Ts; see from_csv.
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::stream_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv_compressed(std::string const& path, columns const& cols, char const& field_sep = ',')
+{
+	return from_csv_compressed(path, cols, field_sep).select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::stream_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv_compressed(std::string const& path, char const& field_sep = ',')
+{
+	return from_csv_compressed<T, Ts...>(path, columns(), field_sep);
+}
+
+} // namespace qolor
+
+#endif // QOLOR_COMPRESSED_CSV_DRIVER_H__
@@ -0,0 +1,64 @@
+#ifndef QOLOR_COMPRESSED_FILE_H__
+#define QOLOR_COMPRESSED_FILE_H__
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace qolor
+{
+
+namespace utils
+{
+
+// Stream buffer over a gzip file (or a file that is not compressed, which is
+// read as is), decompressed on a thread of its own. The thread fills buffers
+// of buffer_size bytes, at most num_buffers ahead of the reader, and the
+// reader gets them as they are: the text is not copied again. Throws
+// std::system_error if the file cannot be opened; errors in the compressed
+// data are thrown by the reads, as std::runtime_error.
+class decompressing_streambuf : public std::streambuf
+{
+private:
+	struct state;
+	std::unique_ptr<state> state_;
+
+	decompressing_streambuf(decompressing_streambuf const&) = delete;
+	decompressing_streambuf& operator=(decompressing_streambuf const&) = delete;
+
+protected:
+	int_type underflow() override;
+
+public:
+	static constexpr size_t default_buffer_size = 1 << 20;
+	static constexpr size_t default_num_buffers = 4;
+
+	explicit decompressing_streambuf(std::string const& path,
+		size_t buffer_size = default_buffer_size, size_t num_buffers = default_num_buffers);
+	~decompressing_streambuf();
+};
+
+// Input stream over a decompressing_streambuf. Errors of the decompression
+// are thrown, not just set as badbit.
+class compressed_istream : public std::istream
+{
+private:
+	decompressing_streambuf buf_;
+
+public:
+	explicit compressed_istream(std::string const& path,
+		size_t buffer_size = decompressing_streambuf::default_buffer_size,
+		size_t num_buffers = decompressing_streambuf::default_num_buffers)
+		: std::istream(nullptr), buf_(path, buffer_size, num_buffers) {
+		rdbuf(&buf_);
+		exceptions(std::ios::badbit);
+	}
+};
+
+} // namespace utils
+
+} // namespace qolor
+
+#endif // QOLOR_COMPRESSED_FILE_H__
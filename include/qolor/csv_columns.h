@@ -0,0 +1,83 @@
+#ifndef QOLOR_CSV_COLUMNS_H__
+#define QOLOR_CSV_COLUMNS_H__
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qolor
+{
+
+// The columns that a scan of delimited text reads, by index or by the names
+// in its header (the first row, which is then not a row of the scan). Rows
+// hold the fields of these columns only, in the order given here; the other
+// fields are skipped without being copied. Columns that a row does not have
+// are empty.
+class columns
+{
+private:
+	std::vector<size_t> indexes_;
+	std::vector<std::string> names_;
+
+	static void check_unique(std::vector<size_t> const& indexes) {
+		for (size_t i = 0; i < indexes.size(); ++i)
+			for (size_t j = i + 1; j < indexes.size(); ++j)
+				if (indexes[i] == indexes[j]) throw std::invalid_argument("qolor: column " + std::to_string(indexes[i]) + " is repeated");
+	}
+
+	// Names are narrow: the header of a wide stream is compared with them
+	// widened.
+	template <typename CharT>
+	static bool is_named(std::basic_string<CharT> const& field, std::string const& name) {
+		return field == std::basic_string<CharT>(name.begin(), name.end());
+	}
+
+	template <typename Field>
+	static bool is_named(Field const& field, std::string const& name) { return field == name; }
+
+public:
+	// All the columns.
+	columns() {}
+
+	explicit columns(std::initializer_list<size_t> indexes) : indexes_(indexes) { check_unique(indexes_); }
+	explicit columns(std::vector<size_t> const& indexes) : indexes_(indexes) { check_unique(indexes_); }
+	explicit columns(std::initializer_list<std::string> names) : names_(names) {}
+	explicit columns(std::vector<std::string> const& names) : names_(names) {}
+
+	bool by_name() const { return !names_.empty(); }
+	size_t size() const { return by_name()? names_.size() : indexes_.size(); }
+
+	// Column indexes (none for all), with names looked up in header (anything with size()
+	// and an operator[] that compares with strings). Throws
+	// std::invalid_argument for names that are not there.
+	template <typename Row>
+	std::vector<size_t> resolve(Row const& header) const {
+		if (!by_name()) return indexes_;
+		std::vector<size_t> ret;
+		for (auto const& name : names_) {
+			size_t i = 0;
+			while (i < header.size() && !is_named(header[i], name)) ++i;
+			if (i == header.size()) throw std::invalid_argument("qolor: no column named " + name);
+			ret.push_back(i);
+		}
+		check_unique(ret);
+		return ret;
+	}
+
+	// Output position of every column up to the last one read, or -1 for the
+	// columns that are skipped.
+	static std::vector<int> slots(std::vector<size_t> const& indexes) {
+		std::vector<int> ret;
+		for (size_t i = 0; i < indexes.size(); ++i) {
+			if (indexes[i] >= ret.size()) ret.resize(indexes[i] + 1, -1);
+			ret[indexes[i]] = int(i);
+		}
+		return ret;
+	}
+};
+
+} // namespace qolor
+
+#endif // QOLOR_CSV_COLUMNS_H__
@@ -0,0 +1,33 @@
+#ifndef QOLOR_CSV_SCANNER_H__
+#define QOLOR_CSV_SCANNER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace csv
+{
+
+// Finds the structural characters of data[0, size): the separators and the
+// newlines that are not inside quotes. Their offsets are written to out, which
+// needs room for size entries, and their number is returned.
+//
+// The text is classified 64 bytes at a time into bitmasks of quotes,
+// separators and newlines (with SSE2 or AVX2 when the CPU has them). The
+// quoted parts of a block are the prefix-XOR of its quote mask, so doubled
+// quotes cancel out. in_quotes carries the state over to the next call: all
+// ones when data ended inside quotes, zero otherwise. It starts at zero.
+size_t scan_structurals(char const* data, size_t size, char sep, uint64_t& in_quotes, uint32_t* out);
+
+} // namespace csv
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_CSV_SCANNER_H__
@@ -5,10 +5,14 @@
 // http://cm.bell-labs.com/cm/cs/tpop/csvgetlinec++.c
 
 #include "basic_iterable.h"
+#include "csv_columns.h"
+#include "field_filter.h"
 #include <istream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <tuple>
+#include <type_traits>
 
 namespace qolor
 {
@@ -45,16 +49,16 @@ struct getter
 	sstream s_;
 
 	void get(string const& s,    CharT& d)      { d = s[0]; }
-	void get(string const& s,   int8_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,  uint8_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,  int16_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s, uint16_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,  int32_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s, uint32_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,  int64_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s, uint64_t& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,   double& d)      { s_.str() = s; s_ >> d; }
-	void get(string const& s,    float& d)      { s_.str() = s; s_ >> d; }
+	void get(string const& s,   int8_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,  uint8_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,  int16_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s, uint16_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,  int32_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s, uint32_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,  int64_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s, uint64_t& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,   double& d)      { s_.str(s); s_.clear(); s_ >> d; }
+	void get(string const& s,    float& d)      { s_.str(s); s_.clear(); s_ >> d; }
 	void get(string const& s, CharT const*& d)  { d = s.c_str(); }
 	void get(string const& s, string& d)        { d = s; }
 	void get(string const&  , null_type const&) {}
@@ -85,34 +89,83 @@ private:
 	string_type cur_line_;  // input line
 	value_type fields_;     // field strings
 	string_type field_sep_; // separator characters
+	bool at_end_;           // no more lines; always set in end iterators
+	std::vector<int> slots_; // position in fields_ of each column (see columns); empty for all
+	nfields num_slots_;
 
 	typedef typename std::basic_string<CharT>::size_type strsize_t;
 
+	field_filter filter_;
+	size_t filter_columns_; // fields of a line that the filter looks at
+	std::vector<strsize_t> starts_, ends_; // of the fields of the line, when filtering
+	string_type filter_field_; // a quoted field, unescaped
+
 	// unquoted field; return index of next separator
 	static inline strsize_t advplain(string_type const& line, string_type const& sep, strsize_t const& i, string_type& fld) {
 		strsize_t j = line.find_first_of(sep, i);
 		if (j > line.length()) j = line.length();
-		fld = line.substr(i, j - i);
+		fld.assign(line, i, j - i);
 		return j;
 	}
 
-	// Quoted field; return index of next separator
+	// Quoted field; return index of next separator. Doubled quotes are
+	// unescaped, text after the closing quote is kept.
 	static inline strsize_t advquoted(string_type const& line, string_type const& sep, strsize_t const& i, string_type& fld) {
 		fld.clear();
-		strsize_t retIndex = line.length();
-		for (strsize_t j = i; j < retIndex; j++) {
-			if (line[j] != '"' || j >= retIndex - 1 || line[j + 1] == '"') {
+		strsize_t const len = line.length();
+		for (strsize_t j = i; j < len; j++) {
+			if (line[j] != '"') {
 				fld += line[j];
 				continue;
 			}
-			retIndex = line.find_first_of(sep, j);
-			if (retIndex > line.length()) retIndex = line.length();
-			for (; j < retIndex; ++j)
-				fld += line[j];
+			if (j + 1 < len && line[j + 1] == '"') {
+				fld += line[j++];
+				continue;
+			}
+			strsize_t retIndex = line.find_first_of(sep, j + 1);
+			if (retIndex > len) retIndex = len;
+			fld.append(line, j + 1, retIndex - j - 1);
+			return retIndex;
 		}
-		return retIndex;
+		return len;
 	}
 
+	// Field that is not read; return index of next separator
+	static inline strsize_t advskip(string_type const& line, string_type const& sep, strsize_t i) {
+		strsize_t const len = line.length();
+		if (line[i] == '"') {
+			for (++i; i < len; ++i) {
+				if (line[i] != '"') continue;
+				if (i + 1 < len && line[i + 1] == '"') ++i;
+				else { ++i; break; }
+			}
+		}
+		strsize_t j = line.find_first_of(sep, i);
+		return (j > len)? len : j;
+	}
+
+	// Whether the line meets the filter, which is checked on the fields it
+	// names only, up to the last of them. Fields are viewed in the line itself;
+	// only quoted ones are copied, to unescape them.
+	bool accepts_line(std::true_type /* char */) {
+		starts_.clear();
+		ends_.clear();
+		for (strsize_t i = 0, len = cur_line_.length(); i < len && starts_.size() < filter_columns_; ++i) {
+			starts_.push_back(i);
+			i = advskip(cur_line_, field_sep_, i);
+			ends_.push_back(i);
+		}
+		return filter_.accepts(starts_.size(), [this](size_t const& k) -> text_view {
+			strsize_t const i = starts_[k];
+			if (cur_line_[i] != '"')
+				return text_view(cur_line_.data() + i, ends_[k] - i);
+			advquoted(cur_line_, field_sep_, i + 1, filter_field_);
+			return text_view(filter_field_);
+		});
+	}
+
+	bool accepts_line(std::false_type) { return true; }
+
 	// Split line into fields
 	static inline value_type split(string_type const& line, string_type const& sep) {
 		value_type fields;
@@ -133,38 +186,85 @@ public:
 	delimited_text_iterator(delimited_text_iterator const&) = default;
 
 	delimited_text_iterator(istream_type& is, const string_type& field_sep)
-		: is_(is), field_sep_(field_sep) {}
+		: is_(is), field_sep_(field_sep), at_end_(false), num_slots_(0), filter_columns_(0) {}
+
+	delimited_text_iterator(istream_type& is) : is_(is), field_sep_(1, ','), at_end_(false), num_slots_(0), filter_columns_(0) {}
+
+	// End iterator.
+	delimited_text_iterator(istream_type& is, qolor::utils::generic_end_iterator const&)
+		: is_(is), at_end_(true), num_slots_(0), filter_columns_(0) {}
+
+	// Splits only the given columns from now on; the rest of a line after the
+	// last of them is not looked at.
+	void project(std::vector<size_t> const& indexes) {
+		slots_ = columns::slots(indexes);
+		num_slots_ = indexes.size();
+	}
 
-	delimited_text_iterator(istream_type& is) : is_(is), field_sep_(1, ',') {}
+	// Skips the lines that do not meet filter from now on. Filters are on
+	// narrow text: throws std::invalid_argument if there is one on a wide
+	// stream, rather than return the lines it would have skipped.
+	void filter(field_filter const& filter) {
+		if (!std::is_same<CharT, char>::value && !filter.empty())
+			throw std::invalid_argument("qolor: field filters are only supported on narrow text");
+		filter_ = filter;
+		filter_columns_ = filter.num_columns();
+	}
 
-	// Get one line, grow as needed
+	// Get one line, grow as needed. The line and the field strings are reused
+	// from one row to the next, so once they have grown to the widest row,
+	// reading does not allocate.
 	delimited_text_iterator & operator++() {
-		fields_.clear();
+		if (!slots_.empty()) {
+			fields_.resize(num_slots_);
+			for (auto& f : fields_) f.clear();
+		}
 		cur_line_.clear();
 
 		while (is_.good() && cur_line_.empty()) {
 			std::getline(is_, cur_line_);
 			if ((!cur_line_.empty()) && (cur_line_.back() == '\r'))
 				cur_line_.pop_back();
+			if (!filter_.empty() && !cur_line_.empty() && !accepts_line(std::is_same<CharT, char>()))
+				cur_line_.clear();
+		}
+		at_end_ = cur_line_.empty();
+		if (at_end_) fields_.clear();
+
+		if (!slots_.empty()) {
+			for (strsize_t i = 0, col = 0, len = cur_line_.length(); i < len && col < slots_.size(); ++i, ++col) {
+				if (slots_[col] < 0)
+					i = advskip(cur_line_, field_sep_, i);
+				else if (cur_line_[i] == '"')
+					i = advquoted(cur_line_, field_sep_, ++i, fields_[slots_[col]]);
+				else
+					i = advplain(cur_line_, field_sep_, i, fields_[slots_[col]]);
+			}
+			return *this;
 		}
 
-		std::basic_string<CharT> tmp;
-		for (strsize_t i = 0, len = cur_line_.length(); i < len; ++i) {
-			fields_.push_back(tmp);
+		nfields n = 0;
+		for (strsize_t i = 0, len = cur_line_.length(); i < len; ++i, ++n) {
+			if (n == fields_.size()) fields_.emplace_back();
 			if (cur_line_[i] == '"')
-				i = advquoted(cur_line_, field_sep_, ++i, fields_.back());
+				i = advquoted(cur_line_, field_sep_, ++i, fields_[n]);
 			else
-				i = advplain(cur_line_, field_sep_, i, fields_.back());
+				i = advplain(cur_line_, field_sep_, i, fields_[n]);
 		}
-	
+		fields_.resize(n);
+
 		return *this;
 	}
 
 	reference operator*() const { return fields_; }
 	pointer operator->() const { return &fields_; }
 
-	bool operator==(const delimited_text_iterator& o) const { return cur_line_ == o.cur_line_; }
-	bool operator!=(const delimited_text_iterator& o) const { return cur_line_ != o.cur_line_; }
+	bool operator==(const delimited_text_iterator& o) const {
+		if (at_end_ || o.at_end_) return at_end_ == o.at_end_;
+		return cur_line_ == o.cur_line_;
+	}
+
+	bool operator!=(const delimited_text_iterator& o) const { return !(*this == o); }
 
 	const string_type & cur_line() const { return cur_line_; }
 	const nfields & num_fields() const { return fields_.size(); }
@@ -226,7 +326,7 @@ from_delimited(std::basic_istream<CharT>& is, const std::basic_string<CharT>& fi
 	typedef internal::csv::delimited_text_iterator<CharT> iter_t;
 	iter_t begin(is, field_sep);
 	++begin;
-	return internal::iterable<iter_t>(std::move(begin), iter_t(is));
+	return internal::iterable<iter_t>(std::move(begin), iter_t(is, utils::generic_end_iterator()));
 }
 
 
@@ -237,7 +337,32 @@ from_csv(std::basic_istream<CharT>& is)
 	typedef internal::csv::delimited_text_iterator<CharT> iter_t;
 	iter_t begin(is);
 	++begin;
-	return internal::iterable<iter_t>(std::move(begin), iter_t(is));
+	return internal::iterable<iter_t>(std::move(begin), iter_t(is, utils::generic_end_iterator()));
+}
+
+
+// Reads the given columns only, of the lines that meet filter; see columns
+// and field_filter.
+template<typename CharT>
+internal::iterable<internal::csv::delimited_text_iterator<CharT>>
+from_delimited(std::basic_istream<CharT>& is, const std::basic_string<CharT>& field_sep, columns const& cols,
+	field_filter const& filter = field_filter())
+{
+	typedef internal::csv::delimited_text_iterator<CharT> iter_t;
+	iter_t begin(is, field_sep);
+	if (cols.by_name()) ++begin; // the header
+	begin.project(cols.resolve(*begin));
+	begin.filter(filter);
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(is, utils::generic_end_iterator()));
+}
+
+
+template<typename CharT>
+internal::iterable<internal::csv::delimited_text_iterator<CharT>>
+from_csv(std::basic_istream<CharT>& is, columns const& cols, field_filter const& filter = field_filter())
+{
+	return from_delimited(is, std::basic_string<CharT>(1, CharT(',')), cols, filter);
 }
 
 
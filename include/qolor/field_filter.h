@@ -0,0 +1,111 @@
+#ifndef QOLOR_FIELD_FILTER_H__
+#define QOLOR_FIELD_FILTER_H__
+
+#include "field_parsers.h"
+#include "text_view.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qolor
+{
+
+// Conditions on the text of fields, which the CSV drivers check before they
+// split a row: rows that do not meet all of them are skipped without any
+// of their fields being copied or converted. Columns are indexes in the
+// file, whatever the columns that the scan reads.
+//
+//     qolor::from_csv_file(path, qolor::columns(), qolor::field_filter().equals(2, "FR").between(5, 10, 20))
+class field_filter
+{
+private:
+	enum kind_t { equals_kind, prefix_kind, range_kind };
+
+	struct condition
+	{
+		kind_t kind;
+		size_t column;
+		std::string text;
+		double lo, hi;
+	};
+
+	std::vector<condition> conditions_;
+
+	field_filter& add(kind_t const& kind, size_t const& column, std::string const& text, double const& lo, double const& hi) {
+		condition c = { kind, column, text, lo, hi };
+		conditions_.push_back(c);
+		return *this;
+	}
+
+public:
+	// The field is value.
+	field_filter& equals(size_t const& column, std::string const& value) { return add(equals_kind, column, value, 0, 0); }
+
+	// The field starts with prefix.
+	field_filter& starts_with(size_t const& column, std::string const& prefix) { return add(prefix_kind, column, prefix, 0, 0); }
+
+	// The field is a number in [lo, hi]. Empty fields and fields that are not
+	// numbers are not.
+	field_filter& between(size_t const& column, double const& lo, double const& hi) { return add(range_kind, column, std::string(), lo, hi); }
+
+	bool empty() const { return conditions_.empty(); }
+
+	// The number of leading fields of a row the conditions look at: the ones
+	// after them need not be found.
+	size_t num_columns() const {
+		size_t n = 0;
+		for (auto const& c : conditions_)
+			if (c.column >= n) n = c.column + 1;
+		return n;
+	}
+
+	struct range
+	{
+		size_t column;
+		double lo, hi;
+	};
+
+	// The between() conditions, for sources of typed values, which take no
+	// other conditions: throws std::invalid_argument if there is any.
+	std::vector<range> ranges() const {
+		std::vector<range> ret;
+		for (auto const& c : conditions_) {
+			if (c.kind != range_kind) throw std::invalid_argument("qolor: only between() filters apply to typed columns");
+			range r = { c.column, c.lo, c.hi };
+			ret.push_back(r);
+		}
+		return ret;
+	}
+
+	// Whether a row of num_fields fields meets every condition; field(i)
+	// returns the text of field i, unescaped.
+	template <typename FieldText>
+	bool accepts(size_t const& num_fields, FieldText&& field) const {
+		for (auto const& c : conditions_) {
+			if (c.column >= num_fields) return false;
+			text_view const t = field(c.column);
+			switch (c.kind) {
+			case equals_kind:
+				if (t != text_view(c.text)) return false;
+				break;
+			case prefix_kind:
+				if (!t.starts_with(text_view(c.text))) return false;
+				break;
+			case range_kind: {
+				double v;
+				char const* b = t.data();
+				char const* e = b + t.size();
+				internal::csv::detail::trim(b, e);
+				if (b == e || !internal::csv::detail::try_parse_double(b, e, v) || !(v >= c.lo && v <= c.hi)) return false;
+				break;
+			}
+			}
+		}
+		return true;
+	}
+};
+
+} // namespace qolor
+
+#endif // QOLOR_FIELD_FILTER_H__
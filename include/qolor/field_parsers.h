@@ -0,0 +1,242 @@
+#ifndef QOLOR_FIELD_PARSERS_H__
+#define QOLOR_FIELD_PARSERS_H__
+
+#include "text_view.hpp"
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace csv
+{
+
+// Conversion of the text of a field to a value, in place: no locales, no
+// streams and no allocations, except for strings. Spaces around numbers are
+// ignored and empty fields are zero. Invalid numbers throw
+// std::invalid_argument, integers out of the range of their type throw
+// std::out_of_range.
+
+typedef decltype(std::ignore) null_type;
+
+namespace detail
+{
+
+inline bool is_space(char const& c) { return c == ' ' || c == '\t'; }
+
+inline void trim(char const*& b, char const*& e)
+{
+	while (b != e && is_space(*b)) ++b;
+	while (b != e && is_space(e[-1])) --e;
+}
+
+[[noreturn]] inline void invalid(char const* b, char const* e, char const* type)
+{
+	throw std::invalid_argument("qolor: \"" + std::string(b, e) + "\" is not a valid " + type);
+}
+
+// Digits of b..e into v; false on overflow.
+inline bool parse_digits(char const* b, char const* e, uint64_t& v)
+{
+	v = 0;
+	for (; b != e; ++b) {
+		unsigned const d = unsigned(*b - '0');
+		if (d > 9) return false;
+		if (v > (std::numeric_limits<uint64_t>::max() - d) / 10) return false;
+		v = v * 10 + d;
+	}
+	return true;
+}
+
+template <typename T>
+void parse_integer(char const* b, char const* e, T& out, std::true_type /* signed */)
+{
+	trim(b, e);
+	if (b == e) { out = 0; return; }
+	char const* const text = b;
+	bool const negative = (*b == '-');
+	if (*b == '-' || *b == '+') ++b;
+	uint64_t v;
+	if (b == e || unsigned(*b - '0') > 9) invalid(text, e, "integer");
+	if (!parse_digits(b, e, v)) {
+		for (char const* p = b; p != e; ++p) if (unsigned(*p - '0') > 9) invalid(text, e, "integer");
+		throw std::out_of_range("qolor: integer out of range: " + std::string(text, e));
+	}
+	uint64_t const max = uint64_t(std::numeric_limits<T>::max());
+	if (v > max + negative) throw std::out_of_range("qolor: integer out of range: " + std::string(text, e));
+	out = negative? T(-int64_t(v - 1) - 1) : T(v);
+}
+
+template <typename T>
+void parse_integer(char const* b, char const* e, T& out, std::false_type /* unsigned */)
+{
+	trim(b, e);
+	if (b == e) { out = 0; return; }
+	char const* const text = b;
+	if (*b == '+') ++b;
+	uint64_t v;
+	if (b == e || unsigned(*b - '0') > 9) invalid(text, e, "unsigned integer");
+	if (!parse_digits(b, e, v)) {
+		for (char const* p = b; p != e; ++p) if (unsigned(*p - '0') > 9) invalid(text, e, "unsigned integer");
+		throw std::out_of_range("qolor: integer out of range: " + std::string(text, e));
+	}
+	if (v > uint64_t(std::numeric_limits<T>::max()))
+		throw std::out_of_range("qolor: integer out of range: " + std::string(text, e));
+	out = T(v);
+}
+
+// Numbers with up to 19 significant digits and a decimal exponent up to 22
+// are exact as m * 10^e or m / 10^e, since both m and 10^e are exact doubles
+// and the one operation rounds correctly (Clinger's fast path). Other numbers
+// (and inf/nan) go through a stream with the classic locale. Returns false
+// for invalid numbers.
+inline bool try_parse_double(char const* b, char const* e, double& out)
+{
+	static double const powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	trim(b, e);
+	if (b == e) { out = 0; return true; }
+	char const* const text = b;
+	bool const negative = (*b == '-');
+	if (*b == '-' || *b == '+') ++b;
+
+	uint64_t m = 0;
+	int digits = 0;  // significant digits in m
+	int exp10 = 0;
+	bool any = false;
+	for (; b != e && unsigned(*b - '0') <= 9; ++b, any = true) {
+		if (digits < 19) { m = m * 10 + unsigned(*b - '0'); digits += (m != 0); }
+		else ++exp10, digits = 20;
+	}
+	if (b != e && *b == '.') {
+		for (++b; b != e && unsigned(*b - '0') <= 9; ++b, any = true) {
+			if (digits < 19) { m = m * 10 + unsigned(*b - '0'); digits += (m != 0); --exp10; }
+			else digits = 20;
+		}
+	}
+	if (any && b != e && (*b == 'e' || *b == 'E')) {
+		++b;
+		bool const neg_exp = (b != e && *b == '-');
+		if (b != e && (*b == '-' || *b == '+')) ++b;
+		if (b == e || unsigned(*b - '0') > 9) return false;
+		int x = 0;
+		for (; b != e && unsigned(*b - '0') <= 9; ++b)
+			if (x < 100000) x = x * 10 + int(*b - '0');
+		exp10 += neg_exp? -x : x;
+	}
+
+	if (any && b == e && digits <= 19 && m <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+		double v = double(m);
+		v = (exp10 < 0)? v / powers[-exp10] : v * powers[exp10];
+		out = negative? -v : v;
+		return true;
+	}
+
+	std::istringstream is(std::string(text, e));
+	is.imbue(std::locale::classic());
+	if (!(is >> out) || is.peek() != std::char_traits<char>::eof()) {
+		// Streams do not read inf and nan.
+		std::string lower;
+		for (char const* p = (*text == '-' || *text == '+')? text + 1 : text; p != e; ++p)
+			lower += char(std::tolower(static_cast<unsigned char>(*p)));
+		if (lower == "inf" || lower == "infinity") out = std::numeric_limits<double>::infinity();
+		else if (lower == "nan") out = std::numeric_limits<double>::quiet_NaN();
+		else return false;
+		if (negative) out = -out;
+	}
+	return true;
+}
+
+inline double parse_double(char const* b, char const* e)
+{
+	double v;
+	if (!try_parse_double(b, e, v)) invalid(b, e, "number");
+	return v;
+}
+
+} // namespace detail
+
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value>::type
+parse_field(char const* b, char const* e, T& out)
+{
+	detail::parse_integer(b, e, out, std::is_signed<T>());
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+parse_field(char const* b, char const* e, T& out)
+{
+	out = T(detail::parse_double(b, e));
+}
+
+inline void parse_field(char const* b, char const* e, bool& out)
+{
+	detail::trim(b, e);
+	text_view const v(b, size_t(e - b));
+	if (v.empty() || v == "0" || v == "false" || v == "FALSE" || v == "False") out = false;
+	else if (v == "1" || v == "true" || v == "TRUE" || v == "True") out = true;
+	else detail::invalid(b, e, "boolean");
+}
+
+inline void parse_field(char const* b, char const* e, char& out) { out = (b != e)? *b : '\0'; }
+inline void parse_field(char const* b, char const* e, std::string& out) { out.assign(b, e); }
+inline void parse_field(char const* b, char const* e, text_view& out) { out = text_view(b, size_t(e - b)); }
+inline void parse_field(char const*, char const*, null_type const&) {}
+
+
+// Decodes the fields of a row (anything with size() and an operator[] that
+// returns a text_view) into the elements of a tuple. Missing fields leave
+// their elements value-initialized; extra fields are ignored.
+template <typename Tuple, size_t I = 0, size_t N = std::tuple_size<Tuple>::value>
+struct row_decoder
+{
+	template <typename Row>
+	static void decode(Row const& row, Tuple& t) {
+		if (I >= row.size()) return;
+		text_view const f = row[I];
+		parse_field(f.data(), f.data() + f.size(), std::get<I>(t));
+		row_decoder<Tuple, I + 1, N>::decode(row, t);
+	}
+};
+
+template <typename Tuple, size_t N>
+struct row_decoder<Tuple, N, N>
+{
+	template <typename Row>
+	static void decode(Row const&, Tuple&) {}
+};
+
+template <typename Tuple>
+struct tuple_decoder
+{
+	template <typename Row>
+	Tuple operator()(Row const& row) const {
+		Tuple t = Tuple();
+		row_decoder<Tuple>::decode(row, t);
+		return t;
+	}
+};
+
+} // namespace csv
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_FIELD_PARSERS_H__
@@ -0,0 +1,143 @@
+#ifndef QOLOR_FLAT_HASH_MAP_HPP__
+#define QOLOR_FLAT_HASH_MAP_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// Hash map with open addressing (linear probing) over a flat slot array.
+// Entries are kept densely, in insertion order, in a separate vector, so that
+// lookups touch one slot array and iteration is a plain vector scan.
+// Entries cannot be erased.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_hash_map
+{
+public:
+	typedef Key key_type;
+	typedef Value mapped_type;
+	typedef std::pair<Key, Value> value_type;
+	typedef std::vector<value_type> container_type;
+	typedef typename container_type::iterator iterator;
+	typedef typename container_type::const_iterator const_iterator;
+	typedef typename container_type::size_type size_type;
+
+private:
+	struct slot
+	{
+		size_t hash;
+		size_t index; // index in entries_ plus one; zero for empty slots
+	};
+
+	container_type entries_;
+	std::vector<slot> slots_;
+	size_t mask_;
+	Hash hash_;
+	KeyEqual eq_;
+
+	// std::hash is the identity for integers, which makes runs of consecutive
+	// keys collide in the low bits. Fibonacci hashing spreads them.
+	size_t hash_of(Key const& key) const {
+		uint64_t h = uint64_t(hash_(key)) * UINT64_C(0x9E3779B97F4A7C15);
+		return size_t(h ^ (h >> 32));
+	}
+
+	// Index of the slot that holds key, or of the empty slot where it belongs.
+	size_t probe(Key const& key, size_t const& h) const {
+		size_t i = h & mask_;
+		while (slots_[i].index && (slots_[i].hash != h || !eq_(entries_[slots_[i].index - 1].first, key)))
+			i = (i + 1) & mask_;
+		return i;
+	}
+
+	void rehash(size_t const& num_slots) {
+		std::vector<slot> old;
+		old.swap(slots_);
+		slots_.assign(num_slots, slot());
+		mask_ = num_slots - 1;
+		for (auto const& s : old) {
+			if (!s.index) continue;
+			size_t i = s.hash & mask_;
+			while (slots_[i].index) i = (i + 1) & mask_;
+			slots_[i] = s;
+		}
+	}
+
+	// Keeps the load factor at most 3/4.
+	void grow_for(size_t const& n) {
+		size_t num_slots = slots_.size();
+		while (4 * n > 3 * num_slots) num_slots *= 2;
+		if (num_slots != slots_.size()) rehash(num_slots);
+	}
+
+public:
+	explicit flat_hash_map(size_t const& expected_size = 0, Hash const& h = Hash(), KeyEqual const& eq = KeyEqual())
+		: slots_(16), mask_(15), hash_(h), eq_(eq) { reserve(expected_size); }
+
+	flat_hash_map(flat_hash_map const&) = default;
+	flat_hash_map(flat_hash_map&&) = default;
+	flat_hash_map& operator=(flat_hash_map const&) = default;
+	flat_hash_map& operator=(flat_hash_map&&) = default;
+
+	void reserve(size_t const& n) {
+		entries_.reserve(n);
+		grow_for(n);
+	}
+
+	void clear() {
+		entries_.clear();
+		slots_.assign(slots_.size(), slot());
+	}
+
+	size_type size() const { return entries_.size(); }
+	bool empty() const { return entries_.empty(); }
+
+	iterator begin() { return entries_.begin(); }
+	iterator end() { return entries_.end(); }
+	const_iterator begin() const { return entries_.begin(); }
+	const_iterator end() const { return entries_.end(); }
+
+	iterator find(Key const& key) {
+		size_t i = probe(key, hash_of(key));
+		return slots_[i].index? entries_.begin() + (slots_[i].index - 1) : entries_.end();
+	}
+
+	const_iterator find(Key const& key) const {
+		size_t i = probe(key, hash_of(key));
+		return slots_[i].index? entries_.begin() + (slots_[i].index - 1) : entries_.end();
+	}
+
+	size_type count(Key const& key) const { return find(key) != end(); }
+
+	// Inserts (key, Value(args...)) if key is not present.
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		size_t const h = hash_of(key);
+		size_t i = probe(key, h);
+		if (slots_[i].index)
+			return std::make_pair(entries_.begin() + (slots_[i].index - 1), false);
+
+		entries_.emplace_back(std::piecewise_construct,
+			std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		slots_[i].hash = h;
+		slots_[i].index = entries_.size();
+		if (4 * entries_.size() > 3 * slots_.size()) rehash(2 * slots_.size());
+		return std::make_pair(entries_.end() - 1, true);
+	}
+
+	Value& operator[](Key const& key) { return try_emplace(key).first->second; }
+};
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_FLAT_HASH_MAP_HPP__
@@ -21,35 +21,41 @@ public:
 	typedef std::input_iterator_tag iterator_category;
 
 private:
-	mutable Func func_;
-	mutable Condition cond_;
+	// Both are empty in the end iterator.
+	mutable qolor::utils::optional_value<Func> func_;
+	mutable qolor::utils::optional_value<Condition> cond_;
 	mutable value_type buf_;
 	mutable bool cond_result_;
 	mutable bool needs_ignition_;
 
 	inline void ignite() const {
 		if (needs_ignition_) {
-			buf_ = func_();
-			cond_result_ = cond_(buf_) && true;
+			buf_ = (*func_)();
+			cond_result_ = (*cond_)(buf_) && true;
 			needs_ignition_ = false;
 		}
 	}
 
+	bool is_end() const { return !func_; }
+
 public:
 	custom_func_iterator() = delete;
 	custom_func_iterator(custom_func_iterator const&) = default;
 	custom_func_iterator(custom_func_iterator&&) = default;
 
 	template<typename F, typename C>
-	custom_func_iterator(F&& f, C&& c, bool const& do_iterate)
+	custom_func_iterator(F&& f, C&& c)
 		: func_(std::forward<F>(f)), cond_(std::forward<C>(c)),
-		cond_result_(do_iterate), needs_ignition_(do_iterate) {}
+		buf_(), cond_result_(true), needs_ignition_(true) {}
+
+	explicit custom_func_iterator(qolor::utils::generic_end_iterator const&)
+		: buf_(), cond_result_(false), needs_ignition_(false) {}
 
 	custom_func_iterator & operator++() {
 		ignite();
 		if (cond_result_) {
-			buf_ = func_();
-			cond_result_ = cond_(buf_) && true;
+			buf_ = (*func_)();
+			cond_result_ = (*cond_)(buf_) && true;
 		}
 		return *this;
 	}
@@ -60,8 +66,14 @@ public:
 		return std::move(i);
 	}
 	
-	bool operator==(custom_func_iterator const& o) const { ignite(); o.ignite(); return cond_result_ == o.cond_result_; }
-	bool operator!=(custom_func_iterator const& o) const { ignite(); o.ignite(); return cond_result_ != o.cond_result_; }
+	bool operator==(custom_func_iterator const& o) const {
+		if (o.is_end()) { ignite(); return !cond_result_; }
+		if (is_end()) { o.ignite(); return !o.cond_result_; }
+		ignite(); o.ignite();
+		return cond_result_ == o.cond_result_;
+	}
+
+	bool operator!=(custom_func_iterator const& o) const { return !(*this == o); }
 
 	bool operator==(qolor::utils::generic_end_iterator const&) const { ignite(); return !cond_result_; }
 	bool operator!=(qolor::utils::generic_end_iterator const&) const { ignite(); return  cond_result_; }
@@ -85,34 +97,40 @@ public:
 	typedef std::input_iterator_tag iterator_category;
 
 private:
-	mutable Func func_;
-	mutable Condition cond_;
+	// Both are empty in the end iterator.
+	mutable qolor::utils::optional_value<Func> func_;
+	mutable qolor::utils::optional_value<Condition> cond_;
 	mutable bool cond_result_;
 	mutable bool needs_ignition_;
 
 	inline void ignite() const {
 		if (needs_ignition_) {
-			func_();
-			cond_result_ = cond_() && true;
+			(*func_)();
+			cond_result_ = (*cond_)() && true;
 			needs_ignition_ = false;
 		}
 	}
 
+	bool is_end() const { return !func_; }
+
 public:
 	custom_func_void_iterator() = delete;
 	custom_func_void_iterator(custom_func_void_iterator const&) = default;
 	custom_func_void_iterator(custom_func_void_iterator&&) = default;
 
 	template<typename F, typename C>
-	custom_func_void_iterator(F&& f, C&& c, bool const& do_iterate)
+	custom_func_void_iterator(F&& f, C&& c)
 		: func_(std::forward<F>(f)), cond_(std::forward<C>(c)),
-		cond_result_(do_iterate), needs_ignition_(do_iterate) {}
+		cond_result_(true), needs_ignition_(true) {}
+
+	explicit custom_func_void_iterator(qolor::utils::generic_end_iterator const&)
+		: cond_result_(false), needs_ignition_(false) {}
 
 	custom_func_void_iterator & operator++() {
 		ignite();
 		if (cond_result_) {
-			func_();
-			cond_result_ = cond_() && true;
+			(*func_)();
+			cond_result_ = (*cond_)() && true;
 		}
 		return *this;
 	}
@@ -123,8 +141,14 @@ public:
 		return std::move(i);
 	}
 	
-	bool operator==(custom_func_void_iterator const& o) const { ignite(); o.ignite(); return cond_result_ == o.cond_result_; }
-	bool operator!=(custom_func_void_iterator const& o) const { ignite(); o.ignite(); return cond_result_ != o.cond_result_; }
+	bool operator==(custom_func_void_iterator const& o) const {
+		if (o.is_end()) { ignite(); return !cond_result_; }
+		if (is_end()) { o.ignite(); return !o.cond_result_; }
+		ignite(); o.ignite();
+		return cond_result_ == o.cond_result_;
+	}
+
+	bool operator!=(custom_func_void_iterator const& o) const { return !(*this == o); }
 
 	bool operator==(qolor::utils::generic_end_iterator const&) const { ignite(); return !cond_result_; }
 	bool operator!=(qolor::utils::generic_end_iterator const&) const { ignite(); return  cond_result_; }
@@ -149,8 +173,8 @@ typename std::enable_if<
 {
 	typedef internal::custom_func_iterator<Func,Condition> iter_t;
 
-	iter_t b(std::forward<Func>(f), std::forward<Condition>(c), true);
-	iter_t e(std::forward<Func>(f), std::forward<Condition>(c), false);
+	iter_t b(std::forward<Func>(f), std::forward<Condition>(c));
+	iter_t e((utils::generic_end_iterator()));
 
 	return internal::iterable<iter_t>(std::move(b), std::move(e));
 }
@@ -161,13 +185,13 @@ typename std::enable_if<
 	qolor::utils::is_functional<Func>::value &&
 	std::is_void<typename qolor::utils::resultof<Func>::type>::value &&
 	qolor::utils::is_functional_predicate<Condition>::value,
-	internal::iterable<internal::custom_func_iterator<Func, Condition>>
+	internal::iterable<internal::custom_func_void_iterator<Func, Condition>>
 >::type from(Func&& f, Condition&& c)
 {
 	typedef internal::custom_func_void_iterator<Func,Condition> iter_t;
 
-	iter_t b(std::forward<Func>(f), std::forward<Condition>(c), true);
-	iter_t e(std::forward<Func>(f), std::forward<Condition>(c), false);
+	iter_t b(std::forward<Func>(f), std::forward<Condition>(c));
+	iter_t e((utils::generic_end_iterator()));
 
 	return internal::iterable<iter_t>(std::move(b), std::move(e));
 }
@@ -0,0 +1,247 @@
+#ifndef QOLOR_FUSED_CHAIN_HPP__
+#define QOLOR_FUSED_CHAIN_HPP__
+
+#include "select_iterator.hpp"
+#include "predicate_iterator.hpp"
+#include <type_traits>
+#include <utility>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// Sinks receive the values of a chain one at a time. Returning false stops
+// the iteration of the whole chain.
+
+template <typename Func, typename Sink>
+struct select_sink
+{
+	Func func_;
+	Sink& sink_;
+
+	select_sink(Func const& f, Sink& s) : func_(f), sink_(s) {}
+
+	template <typename T>
+	bool operator()(T&& v) { return sink_(func_(std::forward<T>(v))); }
+};
+
+template <typename Pred, typename Sink>
+struct where_sink
+{
+	Pred pred_;
+	Sink& sink_;
+
+	where_sink(Pred const& p, Sink& s) : pred_(p), sink_(s) {}
+
+	template <typename T>
+	bool operator()(T&& v) {
+		if (pred_(v)) return sink_(std::forward<T>(v));
+		return true;
+	}
+};
+
+template <typename Pred, typename Sink>
+struct while_sink
+{
+	Pred pred_;
+	Sink& sink_;
+
+	while_sink(Pred const& p, Sink& s) : pred_(p), sink_(s) {}
+
+	template <typename T>
+	bool operator()(T&& v) {
+		if (pred_(v)) return sink_(std::forward<T>(v));
+		return false;
+	}
+};
+
+
+// Terminal sinks, used by the operations of iterable that consume a chain.
+
+template <typename Func>
+struct for_each_sink
+{
+	Func& func_;
+
+	explicit for_each_sink(Func& f) : func_(f) {}
+
+	template <typename T>
+	bool operator()(T&& v) { func_(std::forward<T>(v)); return true; }
+};
+
+template <typename Acc, typename Func>
+struct fold_sink
+{
+	Func& func_;
+	Acc acc_;
+
+	fold_sink(Func& f, Acc const& seed) : func_(f), acc_(seed) {}
+
+	template <typename T>
+	bool operator()(T&& v) { acc_ = func_(acc_, std::forward<T>(v)); return true; }
+};
+
+template <typename Acc, typename Func>
+struct aggregate_sink
+{
+	Func& func_;
+	Acc acc_;
+	bool has_value_;
+
+	explicit aggregate_sink(Func& f) : func_(f), acc_(), has_value_(false) {}
+
+	template <typename T>
+	bool operator()(T&& v) {
+		if (has_value_) acc_ = func_(acc_, std::forward<T>(v));
+		else { acc_ = std::forward<T>(v); has_value_ = true; }
+		return true;
+	}
+};
+
+template <typename Container>
+struct append_sink
+{
+	Container& out_;
+
+	explicit append_sink(Container& out) : out_(out) {}
+
+	template <typename T>
+	bool operator()(T&& v) { out_.push_back(std::forward<T>(v)); return true; }
+};
+
+struct count_sink
+{
+	size_t n_;
+
+	count_sink() : n_(0) {}
+
+	template <typename T>
+	bool operator()(T&&) { ++n_; return true; }
+};
+
+template <typename Value>
+struct count_value_sink
+{
+	Value const& value_;
+	size_t n_;
+
+	explicit count_value_sink(Value const& v) : value_(v), n_(0) {}
+
+	template <typename T>
+	bool operator()(T&& v) { n_ += (value_ == v); return true; }
+};
+
+template <typename Value>
+struct contains_sink
+{
+	Value const& value_;
+	bool found_;
+
+	explicit contains_sink(Value const& v) : value_(v), found_(false) {}
+
+	template <typename T>
+	bool operator()(T&& v) { found_ = (value_ == v); return !found_; }
+};
+
+
+// Unwraps a chain of select/where/while iterators down to the iterator of the
+// source (base_iterator), so that the chain can be run over any part of the
+// source as a single loop, with the functionals of every layer inlined into it.
+template <typename Iter>
+struct fused_chain
+{
+	typedef Iter base_iterator;
+	static constexpr bool is_splittable = true;
+
+	static base_iterator const& base(Iter const& i) { return i; }
+
+	template <typename Sink>
+	static bool run(Iter const&, base_iterator b, base_iterator const& e, Sink& sink) {
+		for (; b != e; ++b)
+			if (!sink(*b)) return false;
+		return true;
+	}
+};
+
+template <typename InnerType, typename FuncType>
+struct fused_chain<select_iterator<InnerType, FuncType>>
+{
+private:
+	typedef select_iterator<InnerType, FuncType> iter_t;
+	typedef fused_chain<typename std::decay<InnerType>::type> inner;
+	typedef typename std::decay<FuncType>::type func_type;
+
+public:
+	typedef typename inner::base_iterator base_iterator;
+	static constexpr bool is_splittable = inner::is_splittable;
+
+	static base_iterator const& base(iter_t const& i) { return inner::base(i.base()); }
+
+	template <typename Sink>
+	static bool run(iter_t const& i, base_iterator const& b, base_iterator const& e, Sink& sink) {
+		select_sink<func_type, Sink> s(i.func(), sink);
+		return inner::run(i.base(), b, e, s);
+	}
+};
+
+template <typename InnerType, typename Pred>
+struct fused_chain<where_iterator<InnerType, Pred>>
+{
+private:
+	typedef where_iterator<InnerType, Pred> iter_t;
+	typedef fused_chain<typename std::decay<InnerType>::type> inner;
+	typedef typename std::decay<Pred>::type pred_type;
+
+public:
+	typedef typename inner::base_iterator base_iterator;
+	static constexpr bool is_splittable = inner::is_splittable;
+
+	static base_iterator const& base(iter_t const& i) { return inner::base(i.cur_); }
+
+	template <typename Sink>
+	static bool run(iter_t const& i, base_iterator const& b, base_iterator const& e, Sink& sink) {
+		if (i.is_end()) return true;
+		where_sink<pred_type, Sink> s(i.pred(), sink);
+		return inner::run(i.cur_, b, e, s);
+	}
+};
+
+// take_while/take depend on everything that came before them, so they cannot
+// be split into independent parts.
+template <typename InnerType, typename Pred>
+struct fused_chain<while_iterator<InnerType, Pred>>
+{
+private:
+	typedef while_iterator<InnerType, Pred> iter_t;
+	typedef fused_chain<typename std::decay<InnerType>::type> inner;
+	typedef typename std::decay<Pred>::type pred_type;
+
+public:
+	typedef typename inner::base_iterator base_iterator;
+	static constexpr bool is_splittable = false;
+
+	static base_iterator const& base(iter_t const& i) { return inner::base(i.cur_); }
+
+	// An iterator that has started (e.g. moved by skip()) is on an element
+	// that has met the predicate already: it is passed on as it is, and the
+	// predicate (e.g. the count of take()) goes on from the next one.
+	template <typename Sink>
+	static bool run(iter_t const& i, base_iterator const& b, base_iterator const& e, Sink& sink) {
+		if (i.is_end()) return true;
+		while_sink<pred_type, Sink> s(i.pred(), sink);
+		if (!i.started_) return inner::run(i.cur_, b, e, s);
+		if (i.cur_ == i.end_) return true;
+		if (!sink(*i.cur_)) return false;
+		typename iter_t::inner_type next(i.cur_);
+		++next;
+		return inner::run(next, inner::base(next), e, s);
+	}
+};
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_FUSED_CHAIN_HPP__
@@ -0,0 +1,255 @@
+#ifndef QOLOR_GROUP_BY_HPP__
+#define QOLOR_GROUP_BY_HPP__
+
+#include "flat_hash_map.hpp"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// An aggregator folds the values of a group into an accumulator. first()
+// initializes the accumulator with the first value of the group and update()
+// adds each of the following ones. result<T>::type is the accumulator type
+// for values of type T.
+struct aggregator_tag {};
+
+struct identity_selector
+{
+	template <typename T>
+	T const& operator()(T const& v) const { return v; }
+};
+
+template <typename Selector>
+class selector_aggregator : public aggregator_tag
+{
+protected:
+	Selector sel_;
+
+public:
+	template <typename T>
+	struct result {
+		typedef typename std::decay<decltype(std::declval<Selector&>()(std::declval<T const&>()))>::type type;
+	};
+
+	explicit selector_aggregator(Selector const& sel) : sel_(sel) {}
+
+	template <typename Acc, typename T>
+	void first(Acc& acc, T const& v) { acc = sel_(v); }
+};
+
+template <typename Selector>
+struct sum_aggregator : public selector_aggregator<Selector>
+{
+	explicit sum_aggregator(Selector const& sel) : selector_aggregator<Selector>(sel) {}
+
+	template <typename Acc, typename T>
+	void update(Acc& acc, T const& v) { acc += this->sel_(v); }
+};
+
+template <typename Selector>
+struct min_aggregator : public selector_aggregator<Selector>
+{
+	explicit min_aggregator(Selector const& sel) : selector_aggregator<Selector>(sel) {}
+
+	template <typename Acc, typename T>
+	void update(Acc& acc, T const& v) {
+		auto&& x = this->sel_(v);
+		if (x < acc) acc = x;
+	}
+};
+
+template <typename Selector>
+struct max_aggregator : public selector_aggregator<Selector>
+{
+	explicit max_aggregator(Selector const& sel) : selector_aggregator<Selector>(sel) {}
+
+	template <typename Acc, typename T>
+	void update(Acc& acc, T const& v) {
+		auto&& x = this->sel_(v);
+		if (acc < x) acc = x;
+	}
+};
+
+struct count_aggregator : public aggregator_tag
+{
+	template <typename T>
+	struct result { typedef size_t type; };
+
+	template <typename T>
+	void first(size_t& acc, T const&) { acc = 1; }
+
+	template <typename T>
+	void update(size_t& acc, T const&) { ++acc; }
+};
+
+struct collect_aggregator : public aggregator_tag
+{
+	template <typename T>
+	struct result { typedef std::vector<T> type; };
+
+	template <typename T>
+	void first(std::vector<T>& acc, T const& v) { acc.push_back(v); }
+
+	template <typename T>
+	void update(std::vector<T>& acc, T const& v) { acc.push_back(v); }
+};
+
+template <typename Seed, typename Func>
+class fold_aggregator : public aggregator_tag
+{
+private:
+	Seed seed_;
+	Func func_;
+
+public:
+	template <typename T>
+	struct result { typedef Seed type; };
+
+	fold_aggregator(Seed const& seed, Func const& f) : seed_(seed), func_(f) {}
+
+	template <typename T>
+	void first(Seed& acc, T const& v) { acc = func_(seed_, v); }
+
+	template <typename T>
+	void update(Seed& acc, T const& v) { acc = func_(acc, v); }
+};
+
+// Plain binary functionals behave like in iterable::aggregate(): the first
+// value of the group is the initial accumulator.
+template <typename Func>
+class function_aggregator : public aggregator_tag
+{
+private:
+	Func func_;
+
+public:
+	template <typename T>
+	struct result { typedef T type; };
+
+	explicit function_aggregator(Func const& f) : func_(f) {}
+
+	template <typename T>
+	void first(T& acc, T const& v) { acc = v; }
+
+	template <typename T>
+	void update(T& acc, T const& v) { acc = func_(acc, v); }
+};
+
+template <typename F, bool IsAggregator = std::is_base_of<aggregator_tag, typename std::decay<F>::type>::value>
+struct aggregator_of { typedef typename std::decay<F>::type type; };
+
+template <typename F>
+struct aggregator_of<F, false> { typedef function_aggregator<typename std::decay<F>::type> type; };
+
+
+template <size_t N>
+struct group_apply
+{
+	template <typename Aggs, typename Accs, typename T>
+	static void first(Aggs& aggs, Accs& accs, T const& v) {
+		group_apply<N - 1>::first(aggs, accs, v);
+		std::get<N - 1>(aggs).first(std::get<N - 1>(accs), v);
+	}
+
+	template <typename Aggs, typename Accs, typename T>
+	static void update(Aggs& aggs, Accs& accs, T const& v) {
+		group_apply<N - 1>::update(aggs, accs, v);
+		std::get<N - 1>(aggs).update(std::get<N - 1>(accs), v);
+	}
+};
+
+template <>
+struct group_apply<0>
+{
+	template <typename Aggs, typename Accs, typename T>
+	static void first(Aggs&, Accs&, T const&) {}
+
+	template <typename Aggs, typename Accs, typename T>
+	static void update(Aggs&, Accs&, T const&) {}
+};
+
+
+template <typename Value, typename KeyFunc, typename... Aggs>
+struct group_by_traits
+{
+	typedef typename std::decay<KeyFunc>::type key_func;
+	typedef typename std::decay<decltype(std::declval<key_func&>()(std::declval<Value const&>()))>::type key_type;
+	typedef std::tuple<typename aggregator_of<Aggs>::type...> aggregators;
+	typedef std::tuple<typename aggregator_of<Aggs>::type::template result<Value>::type...> accumulators;
+	typedef flat_hash_map<key_type, accumulators> map_type;
+};
+
+template <typename Map, typename KeyFunc, typename Aggs>
+struct group_sink
+{
+	Map& map_;
+	KeyFunc& key_;
+	Aggs& aggs_;
+
+	group_sink(Map& m, KeyFunc& k, Aggs& a) : map_(m), key_(k), aggs_(a) {}
+
+	template <typename T>
+	bool operator()(T const& v) {
+		enum { arity = std::tuple_size<Aggs>::value };
+		auto r = map_.try_emplace(key_(v));
+		if (r.second) group_apply<arity>::first(aggs_, r.first->second, v);
+		else group_apply<arity>::update(aggs_, r.first->second, v);
+		return true;
+	}
+};
+
+} // namespace internal
+
+
+namespace agg
+{
+
+inline internal::count_aggregator count() { return internal::count_aggregator(); }
+inline internal::collect_aggregator collect() { return internal::collect_aggregator(); }
+
+inline internal::sum_aggregator<internal::identity_selector> sum() {
+	return internal::sum_aggregator<internal::identity_selector>(internal::identity_selector());
+}
+
+template <typename Selector>
+internal::sum_aggregator<typename std::decay<Selector>::type> sum(Selector&& sel) {
+	return internal::sum_aggregator<typename std::decay<Selector>::type>(std::forward<Selector>(sel));
+}
+
+inline internal::min_aggregator<internal::identity_selector> min() {
+	return internal::min_aggregator<internal::identity_selector>(internal::identity_selector());
+}
+
+template <typename Selector>
+internal::min_aggregator<typename std::decay<Selector>::type> min(Selector&& sel) {
+	return internal::min_aggregator<typename std::decay<Selector>::type>(std::forward<Selector>(sel));
+}
+
+inline internal::max_aggregator<internal::identity_selector> max() {
+	return internal::max_aggregator<internal::identity_selector>(internal::identity_selector());
+}
+
+template <typename Selector>
+internal::max_aggregator<typename std::decay<Selector>::type> max(Selector&& sel) {
+	return internal::max_aggregator<typename std::decay<Selector>::type>(std::forward<Selector>(sel));
+}
+
+template <typename Seed, typename Func>
+internal::fold_aggregator<typename std::decay<Seed>::type, typename std::decay<Func>::type>
+fold(Seed&& seed, Func&& f) {
+	typedef internal::fold_aggregator<typename std::decay<Seed>::type, typename std::decay<Func>::type> agg_t;
+	return agg_t(std::forward<Seed>(seed), std::forward<Func>(f));
+}
+
+} // namespace agg
+
+} // namespace qolor
+
+#endif // QOLOR_GROUP_BY_HPP__
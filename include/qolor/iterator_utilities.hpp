@@ -2,6 +2,9 @@
 #define QOLOR_ITERATOR_UTILITIES_HPP__
 
 #include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace qolor
 {
@@ -103,6 +106,62 @@ struct is_resetable_iterator : public std::integral_constant<bool, iterator_trai
 
 struct generic_end_iterator {};
 
+
+// Storage for a value that may be absent, used for the functionals of
+// iterators: end iterators never call them, so they do not carry a copy.
+// References are stored as pointers.
+template<typename T>
+class optional_value
+{
+private:
+	typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type buf_;
+	bool has_value_;
+
+	T* ptr() { return reinterpret_cast<T*>(&buf_); }
+	T const* ptr() const { return reinterpret_cast<T const*>(&buf_); }
+
+public:
+	optional_value() : has_value_(false) {}
+
+	template<typename U, typename = typename std::enable_if<!std::is_same<typename std::decay<U>::type, optional_value>::value>::type>
+	explicit optional_value(U&& v) : has_value_(true) { new (&buf_) T(std::forward<U>(v)); }
+
+	optional_value(optional_value const& o) : has_value_(o.has_value_) {
+		if (has_value_) new (&buf_) T(*o);
+	}
+
+	optional_value(optional_value&& o) : has_value_(o.has_value_) {
+		if (has_value_) new (&buf_) T(std::move(*o));
+	}
+
+	optional_value& operator=(optional_value const&) = delete;
+
+	~optional_value() { if (has_value_) ptr()->~T(); }
+
+	explicit operator bool() const { return has_value_; }
+
+	T& operator*() { return *ptr(); }
+	T const& operator*() const { return *ptr(); }
+	T* operator->() { return ptr(); }
+	T const* operator->() const { return ptr(); }
+};
+
+template<typename T>
+class optional_value<T&>
+{
+private:
+	T* ptr_;
+
+public:
+	optional_value() : ptr_(nullptr) {}
+	explicit optional_value(T& v) : ptr_(&v) {}
+
+	explicit operator bool() const { return ptr_ != nullptr; }
+
+	T& operator*() const { return *ptr_; }
+	T* operator->() const { return ptr_; }
+};
+
 } // namespace utils
 
 } // namespace qolor
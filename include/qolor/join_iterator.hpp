@@ -3,7 +3,11 @@
 
 #include "iterator_utilities.hpp"
 #include "functional_traits.hpp"
+#include <memory>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace qolor
 {
@@ -94,6 +98,190 @@ public:
 	pointer operator->() const { return pointer(new value_type(*this)); }
 };
 
+// Equi-join on a key extracted from each side. One side (the build side) is
+// read once into a hash table and the other side (the probe side) is streamed
+// once against it, so neither input needs to be resetable.
+template <typename InnerType1, typename InnerType2, typename KeyFunc1, typename KeyFunc2>
+class hash_join_iterator
+{
+private:
+	typedef ::qolor::utils::iterator_traits_ex<InnerType1> traits1;
+	typedef ::qolor::utils::iterator_traits_ex<InnerType2> traits2;
+	typedef typename traits1::deref_type deref_t1;
+	typedef typename traits2::deref_type deref_t2;
+	typedef typename traits1::value_type value_t1;
+	typedef typename traits2::value_type value_t2;
+	typedef typename std::decay<KeyFunc1>::type key_func1;
+	typedef typename std::decay<KeyFunc2>::type key_func2;
+	typedef typename std::decay<decltype(std::declval<key_func1&>()(std::declval<deref_t1>()))>::type key_type;
+	typedef typename std::decay<decltype(std::declval<key_func2&>()(std::declval<deref_t2>()))>::type key_type2;
+
+	static_assert(traits1::is_readable, "First template argument is not a readable iterator.");
+	static_assert(traits2::is_readable, "Second template argument is not a readable iterator.");
+	static_assert(std::is_same<key_type, key_type2>::value, "Both key functionals must return the same type.");
+
+	// Non-tuple values are wrapped, so that they can be concatenated like tuples.
+	template<typename T> static std::tuple<T> as_tuple(T const& v) { return std::tuple<T>(v); }
+	template<typename... Ts> static std::tuple<Ts...> const& as_tuple(std::tuple<Ts...> const& v) { return v; }
+
+	template<typename I> static std::ptrdiff_t known_size(I const& b, I const& e, std::random_access_iterator_tag) { return e - b; }
+	template<typename I, typename Tag> static std::ptrdiff_t known_size(I const&, I const&, Tag) { return -1; }
+
+public:
+	typedef std::ptrdiff_t difference_type;
+	typedef decltype(std::tuple_cat(as_tuple(std::declval<value_t1 const&>()), as_tuple(std::declval<value_t2 const&>()))) value_type;
+	typedef value_type const& reference;
+	typedef value_type const* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+private:
+	struct state
+	{
+		InnerType1 cur1, end1;
+		InnerType2 cur2, end2;
+		key_func1 key1;
+		key_func2 key2;
+		std::unordered_map<key_type, std::vector<value_t1>> table1;
+		std::unordered_map<key_type, std::vector<value_t2>> table2;
+		std::vector<value_t1> const* matches1;
+		std::vector<value_t2> const* matches2;
+		size_t idx;
+		value_t1 probe1;
+		value_t2 probe2;
+		value_type current;
+		bool build_left, started, done;
+
+		template <typename B1, typename E1, typename B2, typename E2, typename F1, typename F2>
+		state(B1&& b1, E1&& e1, B2&& b2, E2&& e2, F1&& k1, F2&& k2)
+			: cur1(std::forward<B1>(b1)), end1(std::forward<E1>(e1)),
+			cur2(std::forward<B2>(b2)), end2(std::forward<E2>(e2)),
+			key1(std::forward<F1>(k1)), key2(std::forward<F2>(k2)),
+			matches1(nullptr), matches2(nullptr), idx(0),
+			build_left(false), started(false), done(false) {}
+
+		void build() {
+			typedef typename traits1::iterator_category cat1;
+			typedef typename traits2::iterator_category cat2;
+			std::ptrdiff_t n1 = known_size(cur1, end1, cat1()), n2 = known_size(cur2, end2, cat2());
+			build_left = (n1 >= 0) && (n2 >= 0) && (n1 < n2);
+
+			if (build_left) {
+				table1.reserve(n1);
+				for (; cur1 != end1; ++cur1) {
+					deref_t1 v = *cur1;
+					table1[key1(v)].push_back(v);
+				}
+			}
+			else {
+				if (n2 >= 0) table2.reserve(n2);
+				for (; cur2 != end2; ++cur2) {
+					deref_t2 v = *cur2;
+					table2[key2(v)].push_back(v);
+				}
+			}
+			started = true;
+		}
+
+		// Advance the probe side up to the next row that has matches.
+		void seek() {
+			idx = 0;
+			if (build_left) {
+				for (; cur2 != end2; ++cur2) {
+					deref_t2 v = *cur2;
+					auto it = table1.find(key2(v));
+					if (it != table1.end()) {
+						probe2 = v;
+						matches1 = &it->second;
+						current = std::tuple_cat(as_tuple((*matches1)[0]), as_tuple(probe2));
+						return;
+					}
+				}
+			}
+			else {
+				for (; cur1 != end1; ++cur1) {
+					deref_t1 v = *cur1;
+					auto it = table2.find(key1(v));
+					if (it != table2.end()) {
+						probe1 = v;
+						matches2 = &it->second;
+						current = std::tuple_cat(as_tuple(probe1), as_tuple((*matches2)[0]));
+						return;
+					}
+				}
+			}
+			done = true;
+		}
+
+		void ignite() {
+			if (!started) {
+				build();
+				seek();
+			}
+		}
+
+		void next() {
+			ignite();
+			if (done) return;
+			++idx;
+			if (build_left) {
+				if (idx < matches1->size()) {
+					current = std::tuple_cat(as_tuple((*matches1)[idx]), as_tuple(probe2));
+					return;
+				}
+				++cur2;
+			}
+			else {
+				if (idx < matches2->size()) {
+					current = std::tuple_cat(as_tuple(probe1), as_tuple((*matches2)[idx]));
+					return;
+				}
+				++cur1;
+			}
+			seek();
+		}
+	};
+
+	std::shared_ptr<state> state_;
+
+	bool at_end() const {
+		if (!state_) return true;
+		state_->ignite();
+		return state_->done;
+	}
+
+public:
+	hash_join_iterator() = default;
+	hash_join_iterator(hash_join_iterator const&) = default;
+	hash_join_iterator(hash_join_iterator&&) = default;
+	hash_join_iterator& operator=(hash_join_iterator const&) = default;
+	hash_join_iterator& operator=(hash_join_iterator&&) = default;
+
+	template <typename B1, typename E1, typename B2, typename E2, typename F1, typename F2>
+	hash_join_iterator(B1&& begin1, E1&& end1, B2&& begin2, E2&& end2, F1&& key1, F2&& key2)
+		: state_(std::make_shared<state>(std::forward<B1>(begin1), std::forward<E1>(end1),
+			std::forward<B2>(begin2), std::forward<E2>(end2), std::forward<F1>(key1), std::forward<F2>(key2))) {}
+
+	bool operator==(hash_join_iterator const& o) const { return at_end() == o.at_end(); }
+	bool operator!=(hash_join_iterator const& o) const { return at_end() != o.at_end(); }
+
+	hash_join_iterator& operator++() { if (state_) state_->next(); return *this; }
+	// Copies of the iterator share their state, so post-increment gives the
+	// row it was at rather than an iterator to it.
+	class row_proxy
+	{
+		value_type row_;
+	public:
+		explicit row_proxy(value_type const& row) : row_(row) {}
+		value_type const& operator*() const { return row_; }
+		value_type const* operator->() const { return &row_; }
+	};
+
+	row_proxy operator++(int) { row_proxy p(**this); ++(*this); return p; }
+
+	reference operator*() const { state_->ignite(); return state_->current; }
+	pointer operator->() const { state_->ignite(); return &state_->current; }
+};
+
 } // namespace internal
 
 } // namespace qolor
@@ -0,0 +1,440 @@
+#ifndef QOLOR_MAPPED_CSV_DRIVER_H__
+#define QOLOR_MAPPED_CSV_DRIVER_H__
+
+#include "basic_iterable.h"
+#include "csv_columns.h"
+#include "csv_scanner.h"
+#include "field_filter.h"
+#include "mapped_file.h"
+#include "text_view.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace csv
+{
+
+// A field of a row: a part of the mapping or, if it had to be unescaped, of
+// the scratch buffer of the row.
+struct field_span
+{
+	size_t offset;
+	size_t size;
+	bool in_scratch;
+};
+
+class parallel_csv_state;
+
+// One row of a memory-mapped file. Fields are views into the mapping, except
+// for quoted fields with escaped quotes, which are unescaped into a buffer of
+// the row. The views stay valid as long as the row and the query it came from.
+class mapped_row
+{
+private:
+	friend class mapped_csv_iterator;
+	friend class parallel_csv_state;
+	friend class stream_csv_iterator;
+
+	char const* data_;
+	std::vector<field_span> fields_;
+	std::string scratch_;
+
+	void clear() {
+		fields_.clear();
+		scratch_.clear();
+	}
+
+public:
+	class const_iterator
+	{
+	private:
+		mapped_row const* row_;
+		size_t i_;
+
+	public:
+		typedef std::ptrdiff_t difference_type;
+		typedef text_view value_type;
+		typedef text_view reference;
+		typedef text_view const* pointer;
+		typedef std::random_access_iterator_tag iterator_category;
+
+		const_iterator() : row_(nullptr), i_(0) {}
+		const_iterator(mapped_row const* row, size_t const& i) : row_(row), i_(i) {}
+
+		reference operator*() const { return (*row_)[i_]; }
+		reference operator[](difference_type const& n) const { return (*row_)[i_ + n]; }
+
+		const_iterator& operator++() { ++i_; return *this; }
+		const_iterator& operator--() { --i_; return *this; }
+		const_iterator operator++(int) { const_iterator t(*this); ++i_; return t; }
+		const_iterator operator--(int) { const_iterator t(*this); --i_; return t; }
+		const_iterator& operator+=(difference_type const& n) { i_ += n; return *this; }
+		const_iterator& operator-=(difference_type const& n) { i_ -= n; return *this; }
+		const_iterator operator+(difference_type const& n) const { return const_iterator(row_, i_ + n); }
+		const_iterator operator-(difference_type const& n) const { return const_iterator(row_, i_ - n); }
+		difference_type operator-(const_iterator const& o) const { return difference_type(i_) - difference_type(o.i_); }
+
+		bool operator==(const_iterator const& o) const { return i_ == o.i_; }
+		bool operator!=(const_iterator const& o) const { return i_ != o.i_; }
+		bool operator< (const_iterator const& o) const { return i_ <  o.i_; }
+		bool operator> (const_iterator const& o) const { return i_ >  o.i_; }
+		bool operator<=(const_iterator const& o) const { return i_ <= o.i_; }
+		bool operator>=(const_iterator const& o) const { return i_ >= o.i_; }
+	};
+
+	typedef text_view value_type;
+	typedef const_iterator iterator;
+	typedef size_t size_type;
+
+	mapped_row() : data_(nullptr) {}
+
+	size_t size() const { return fields_.size(); }
+	bool empty() const { return fields_.empty(); }
+
+	text_view operator[](size_t const& i) const {
+		field_span const& f = fields_[i];
+		return text_view((f.in_scratch? scratch_.data() : data_) + f.offset, f.size);
+	}
+
+	text_view at(size_t const& i) const {
+		if (i >= fields_.size()) throw std::out_of_range("mapped_row::at");
+		return (*this)[i];
+	}
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, fields_.size()); }
+
+	// Copies the fields, for rows that must outlive the query.
+	std::vector<std::string> to_strings() const {
+		std::vector<std::string> ret;
+		ret.reserve(fields_.size());
+		for (size_t i = 0; i < fields_.size(); ++i) ret.push_back((*this)[i].str());
+		return ret;
+	}
+};
+
+
+// Reads the rows of a memory-mapped file (RFC 4180): quoted fields may hold
+// separators, newlines and doubled quotes, lines may end in CRLF and empty
+// lines are skipped.
+//
+// The text is indexed one window at a time by scan_structurals(), and fields
+// are cut at the offsets of the index, without looking at the bytes between
+// them again (except for quoted fields). A parser can start anywhere in the
+// text, given the quote state there.
+class row_parser
+{
+public:
+	static constexpr size_t window_size = 16 * 1024;
+
+private:
+	char const* data_;
+	size_t size_;
+	char sep_;
+	size_t pos_;                  // start of the next row
+
+	// Structurals of the window, relative to window_. Copies of a parser (as
+	// iterators are copied) share them, until one of them scans the next
+	// window into a buffer of its own.
+	std::shared_ptr<std::vector<uint32_t>> index_;
+	size_t window_;               // start of the window
+	size_t scanned_;              // end of the window
+	size_t next_;                 // next structural in *index_
+	size_t num_structurals_;
+	uint64_t in_quotes_;          // scanner state at scanned_
+
+	std::vector<int> slots_;      // position in the row of each column (see columns); empty for all
+	size_t num_slots_;
+
+	field_filter filter_;
+	std::vector<size_t> ends_;    // structurals of the row, when filtering
+	std::string filter_scratch_;
+
+	// Offset of the next structural character, or size_ when there are no more.
+	size_t next_structural() {
+		while (next_ == num_structurals_) {
+			if (scanned_ >= size_) return size_;
+			// Windows start small, for parsers that only read a few rows.
+			size_t const n = std::min(std::min(size_t(window_size), 2 * (scanned_ - window_) + 256), size_ - scanned_);
+			if (!index_ || index_.use_count() > 1) index_ = std::make_shared<std::vector<uint32_t>>();
+			if (index_->size() < n) index_->resize(n);
+			num_structurals_ = scan_structurals(data_ + scanned_, n, sep_, in_quotes_, index_->data());
+			window_ = scanned_;
+			scanned_ += n;
+			next_ = 0;
+		}
+		return window_ + (*index_)[next_++];
+	}
+
+	static void push_span(std::vector<field_span>& fields, size_t const& offset, size_t const& size) {
+		field_span f = { offset, size, false };
+		fields.push_back(f);
+	}
+
+	// Field data_[b, e). Text after the closing quote of a quoted field is kept
+	// as part of the field.
+	void add_field(size_t const& b, size_t e, bool const& last, std::vector<field_span>& fields, std::string& scratch) const {
+		if (last && e > b && data_[e - 1] == '\r') --e;
+		if (e == b || data_[b] != '"') { push_span(fields, b, e - b); return; }
+
+		size_t q = e - 1;
+		while (q > b && data_[q] != '"') --q;
+		size_t const content_end = (q > b)? q : e; // unterminated without a closing quote
+		size_t const tail = (q > b)? q + 1 : e;
+
+		if (tail == e && !std::memchr(data_ + b + 1, '"', content_end - b - 1)) {
+			push_span(fields, b + 1, content_end - b - 1);
+			return;
+		}
+
+		field_span f = { scratch.size(), 0, true };
+		for (size_t j = b + 1; j < content_end; ++j) {
+			scratch += data_[j];
+			if (data_[j] == '"') ++j;
+		}
+		scratch.append(data_ + tail, e - tail);
+		f.size = scratch.size() - f.offset;
+		fields.push_back(f);
+	}
+
+public:
+	row_parser()
+		: data_(""), size_(0), sep_(','), pos_(0),
+		window_(0), scanned_(0), next_(0), num_structurals_(0), in_quotes_(0), num_slots_(0) {}
+
+	// Parses data[start, size), which starts inside quotes if in_quotes is all
+	// ones (as from scan_structurals()).
+	row_parser(char const* data, size_t const& size, char const& sep, size_t const& start = 0, uint64_t const& in_quotes = 0)
+		: data_(data), size_(size), sep_(sep), pos_(start),
+		window_(start), scanned_(start), next_(0), num_structurals_(0), in_quotes_(in_quotes), num_slots_(0) {}
+
+	size_t const& pos() const { return pos_; }
+
+	// Reads only the given columns from now on. The fields of the other
+	// columns are skipped over in the index, without being looked at.
+	void project(std::vector<size_t> const& indexes) {
+		slots_ = columns::slots(indexes);
+		num_slots_ = indexes.size();
+	}
+
+	// Starts over on other text, keeping the buffers.
+	void reset(char const* data, size_t const& size) {
+		data_ = data;
+		size_ = size;
+		pos_ = window_ = scanned_ = next_ = num_structurals_ = 0;
+		in_quotes_ = 0;
+	}
+
+	// Moves to the start of the next line, for parsers started in the middle
+	// of one.
+	void skip_line() {
+		size_t e;
+		while ((e = next_structural()) < size_ && data_[e] != '\n') {}
+		pos_ = std::min(e + 1, size_);
+	}
+
+	// Rows that do not meet filter are skipped from now on.
+	void filter(field_filter const& filter) { filter_ = filter; }
+
+	// Appends the fields of the next row that starts before limit. Returns
+	// false if there is none.
+	bool next_row(std::vector<field_span>& fields, std::string& scratch, size_t const& limit = size_t(-1)) {
+		for (;;) {
+			size_t i = pos_;
+
+			// Empty lines; a newline at the start of a row is always structural,
+			// so rows always start after one.
+			for (;;) {
+				if (i < size_ && data_[i] == '\n') ++i;
+				else if (i + 1 < size_ && data_[i] == '\r' && data_[i + 1] == '\n') i += 2;
+				else break;
+				next_structural();
+			}
+			if (i + 1 == size_ && data_[i] == '\r') ++i;
+			pos_ = i;
+			if (i >= size_ || i >= limit) return false;
+
+			if (filter_.empty()) {
+				read_row(fields, scratch);
+				return true;
+			}
+			if (filtered_row(fields, scratch)) return true;
+		}
+	}
+
+private:
+	// Fields of the row at pos_, which does not end in pos_.
+	void read_row(std::vector<field_span>& fields, std::string& scratch) {
+		size_t i = pos_;
+		if (slots_.empty()) {
+			for (;;) {
+				size_t const e = next_structural();
+				bool const last = (e >= size_ || data_[e] == '\n');
+				add_field(i, e, last, fields, scratch);
+				i = e + 1;
+				if (last) break;
+				// Separator at the end of the text: an empty last field.
+				if (i >= size_) { push_span(fields, size_, 0); break; }
+			}
+		}
+		else {
+			size_t const base = fields.size();
+			fields.resize(base + num_slots_, field_span());
+			for (size_t col = 0; ; ++col) {
+				size_t const e = next_structural();
+				bool const last = (e >= size_ || data_[e] == '\n');
+				if (col < slots_.size() && slots_[col] >= 0) {
+					add_field(i, e, last, fields, scratch);
+					fields[base + slots_[col]] = fields.back();
+					fields.pop_back();
+				}
+				i = e + 1;
+				if (last || i >= size_) break;
+			}
+		}
+		pos_ = std::min(i, size_);
+	}
+
+	// Finds the ends of the fields of the row at pos_ first, checks the filter
+	// on them, and only then cuts the fields of the row if it passes.
+	bool filtered_row(std::vector<field_span>& fields, std::string& scratch) {
+		size_t const b = pos_;
+		ends_.clear();
+		size_t e;
+		do ends_.push_back(e = next_structural());
+		while (e < size_ && data_[e] != '\n');
+		pos_ = std::min(e + 1, size_);
+
+		size_t const n = ends_.size();
+		auto field_begin = [&](size_t const& k) { return (k == 0)? b : ends_[k - 1] + 1; };
+		bool const ok = filter_.accepts(n, [&](size_t const& k) {
+			size_t const base = fields.size();
+			filter_scratch_.clear();
+			add_field(field_begin(k), ends_[k], k + 1 == n, fields, filter_scratch_);
+			field_span const f = fields[base];
+			fields.pop_back();
+			return text_view((f.in_scratch? filter_scratch_.data() : data_) + f.offset, f.size);
+		});
+		if (!ok) return false;
+
+		if (slots_.empty()) {
+			for (size_t k = 0; k < n; ++k)
+				add_field(field_begin(k), ends_[k], k + 1 == n, fields, scratch);
+		}
+		else {
+			size_t const base = fields.size();
+			fields.resize(base + num_slots_, field_span());
+			for (size_t k = 0; k < n && k < slots_.size(); ++k) {
+				if (slots_[k] < 0) continue;
+				add_field(field_begin(k), ends_[k], k + 1 == n, fields, scratch);
+				fields[base + slots_[k]] = fields.back();
+				fields.pop_back();
+			}
+		}
+		return true;
+	}
+};
+
+
+// The row is reused, so reading does not allocate once its buffers have grown
+// to the widest row.
+class mapped_csv_iterator
+{
+public:
+	typedef std::ptrdiff_t difference_type;
+	typedef mapped_row value_type;
+	typedef mapped_row const& reference;
+	typedef mapped_row const* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+private:
+	std::shared_ptr<utils::mapped_file const> file_;
+	row_parser parser_;
+	mapped_row row_;
+	bool at_end_; // no more rows; always set in end iterators
+
+public:
+	mapped_csv_iterator() = delete;
+	mapped_csv_iterator(mapped_csv_iterator&&) = default;
+	mapped_csv_iterator(mapped_csv_iterator const&) = default;
+	mapped_csv_iterator& operator=(mapped_csv_iterator&&) = default;
+	mapped_csv_iterator& operator=(mapped_csv_iterator const&) = default;
+
+	mapped_csv_iterator(std::shared_ptr<utils::mapped_file const> const& file, char const& sep)
+		: file_(file), parser_(file->data(), file->size(), sep), at_end_(false) { row_.data_ = file->data(); }
+
+	// End iterator.
+	explicit mapped_csv_iterator(qolor::utils::generic_end_iterator const&) : at_end_(true) {}
+
+	void project(std::vector<size_t> const& indexes) { parser_.project(indexes); }
+	void filter(field_filter const& filter) { parser_.filter(filter); }
+
+	mapped_csv_iterator& operator++() {
+		row_.clear();
+		at_end_ = !parser_.next_row(row_.fields_, row_.scratch_);
+		return *this;
+	}
+
+	reference operator*() const { return row_; }
+	pointer operator->() const { return &row_; }
+
+	bool operator==(mapped_csv_iterator const& o) const {
+		if (at_end_ || o.at_end_) return at_end_ == o.at_end_;
+		return parser_.pos() == o.parser_.pos();
+	}
+
+	bool operator!=(mapped_csv_iterator const& o) const { return !(*this == o); }
+};
+
+} // namespace csv
+
+} // namespace internal
+
+
+// Memory-maps the file at path and reads it as delimited text. Throws
+// std::system_error if the file cannot be read.
+inline internal::iterable<internal::csv::mapped_csv_iterator>
+from_csv_file(std::string const& path, char const& field_sep = ',')
+{
+	typedef internal::csv::mapped_csv_iterator iter_t;
+	std::shared_ptr<utils::mapped_file const> file = std::make_shared<utils::mapped_file>(path);
+	iter_t begin(file, field_sep);
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(utils::generic_end_iterator()));
+}
+
+// Reads the given columns only, of the rows that meet filter; see columns
+// and field_filter.
+inline internal::iterable<internal::csv::mapped_csv_iterator>
+from_csv_file(std::string const& path, columns const& cols, field_filter const& filter, char const& field_sep = ',')
+{
+	typedef internal::csv::mapped_csv_iterator iter_t;
+	std::shared_ptr<utils::mapped_file const> file = std::make_shared<utils::mapped_file>(path);
+	iter_t begin(file, field_sep);
+	if (cols.by_name()) ++begin; // the header
+	begin.project(cols.resolve(*begin));
+	begin.filter(filter);
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(utils::generic_end_iterator()));
+}
+
+// Reads the given columns only; see columns.
+inline internal::iterable<internal::csv::mapped_csv_iterator>
+from_csv_file(std::string const& path, columns const& cols, char const& field_sep = ',')
+{
+	return from_csv_file(path, cols, field_filter(), field_sep);
+}
+
+} // namespace qolor
+
+#endif // QOLOR_MAPPED_CSV_DRIVER_H__
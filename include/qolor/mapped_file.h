@@ -0,0 +1,37 @@
+#ifndef QOLOR_MAPPED_FILE_H__
+#define QOLOR_MAPPED_FILE_H__
+
+#include <cstddef>
+#include <string>
+
+namespace qolor
+{
+
+namespace utils
+{
+
+// Read-only memory mapping of a whole file. Throws std::system_error if the
+// file cannot be opened or mapped.
+class mapped_file
+{
+private:
+	char const* data_;
+	size_t size_;
+	bool mapped_; // false when the contents were read into memory instead
+
+	mapped_file(mapped_file const&) = delete;
+	mapped_file& operator=(mapped_file const&) = delete;
+
+public:
+	explicit mapped_file(std::string const& path);
+	~mapped_file();
+
+	char const* data() const { return data_; }
+	size_t size() const { return size_; }
+};
+
+} // namespace utils
+
+} // namespace qolor
+
+#endif // QOLOR_MAPPED_FILE_H__
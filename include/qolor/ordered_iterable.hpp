@@ -0,0 +1,215 @@
+#ifndef QOLOR_ORDERED_ITERABLE_HPP__
+#define QOLOR_ORDERED_ITERABLE_HPP__
+
+#include "basic_iterable.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// Elements of an ordered_iterable, sorted the first time they are needed, and
+// shared by the iterators over them.
+template <typename Value>
+class sorted_buffer
+{
+public:
+	typedef std::vector<Value> container_type;
+
+private:
+	std::function<container_type()> sort_;
+	container_type values_;
+	bool sorted_;
+
+public:
+	explicit sorted_buffer(std::function<container_type()> const& sort) : sort_(sort), sorted_(false) {}
+
+	bool is_sorted() const { return sorted_; }
+
+	container_type const& get() {
+		if (!sorted_) {
+			values_ = sort_();
+			sorted_ = true;
+		}
+		return values_;
+	}
+};
+
+// Iterator over a sorted_buffer. The end iterator is past the elements,
+// however many they turn out to be once they are sorted.
+template <typename Value>
+class ordered_iterator
+{
+public:
+	typedef Value value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef Value const& reference;
+	typedef Value const* pointer;
+	typedef std::random_access_iterator_tag iterator_category;
+
+	static constexpr size_t at_end = std::numeric_limits<size_t>::max();
+
+private:
+	std::shared_ptr<sorted_buffer<Value>> buf_;
+	size_t i_;
+
+	size_t pos() const { return (i_ == at_end)? buf_->get().size() : i_; }
+
+public:
+	ordered_iterator() : i_(0) {}
+	ordered_iterator(std::shared_ptr<sorted_buffer<Value>> const& buf, size_t const& i) : buf_(buf), i_(i) {}
+
+	ordered_iterator& operator++() { i_ = pos() + 1; return *this; }
+	ordered_iterator& operator--() { i_ = pos() - 1; return *this; }
+	ordered_iterator operator++(int) { ordered_iterator i(*this); ++(*this); return i; }
+	ordered_iterator operator--(int) { ordered_iterator i(*this); --(*this); return i; }
+
+	ordered_iterator& operator+=(difference_type const& n) { i_ = pos() + n; return *this; }
+	ordered_iterator& operator-=(difference_type const& n) { i_ = pos() - n; return *this; }
+	ordered_iterator operator+(difference_type const& n) const { return ordered_iterator(buf_, pos() + n); }
+	ordered_iterator operator-(difference_type const& n) const { return ordered_iterator(buf_, pos() - n); }
+	difference_type operator-(ordered_iterator const& o) const { return difference_type(pos()) - difference_type(o.pos()); }
+
+	bool operator==(ordered_iterator const& o) const { return pos() == o.pos(); }
+	bool operator!=(ordered_iterator const& o) const { return pos() != o.pos(); }
+	bool operator< (ordered_iterator const& o) const { return pos() <  o.pos(); }
+	bool operator> (ordered_iterator const& o) const { return pos() >  o.pos(); }
+	bool operator<=(ordered_iterator const& o) const { return pos() <= o.pos(); }
+	bool operator>=(ordered_iterator const& o) const { return pos() >= o.pos(); }
+
+	reference operator*() const { return buf_->get()[i_]; }
+	reference operator[](difference_type const& n) const { return buf_->get()[pos() + n]; }
+	pointer operator->() const { return &buf_->get()[i_]; }
+};
+
+template <typename Value>
+constexpr size_t ordered_iterator<Value>::at_end;
+
+// Result of iterable::order_by(), an iterable like any other. Nothing is
+// sorted until the elements are needed. The order is stable: elements with
+// equal keys keep the order of the source. take(k) keeps only the first k
+// elements, which are then selected with a bounded heap in O(n log k) time
+// and O(k) space instead of a full sort.
+template <typename IteratorType, typename KeyFunc, bool Descending>
+class ordered_iterable : public iterable<ordered_iterator<typename iterable<IteratorType>::value_type>>
+{
+public:
+	typedef typename iterable<IteratorType>::value_type value_type;
+	typedef typename std::decay<decltype(std::declval<KeyFunc&>()(std::declval<value_type const&>()))>::type key_type;
+	typedef std::vector<value_type> container_type;
+	typedef ordered_iterator<value_type> iterator;
+
+private:
+	typedef iterable<iterator> base_t;
+	typedef sorted_buffer<value_type> buffer_type;
+	typedef typename std::conditional<Descending, std::greater<key_type>, std::less<key_type>>::type compare_type;
+
+	struct entry
+	{
+		key_type key;
+		size_t seq;
+		value_type value;
+	};
+
+	// Ties are broken by the position in the source, which makes the order
+	// stable even though neither std::sort nor the heap are.
+	struct entry_less
+	{
+		compare_type comp;
+
+		bool operator()(entry const& a, entry const& b) const {
+			if (comp(a.key, b.key)) return true;
+			if (comp(b.key, a.key)) return false;
+			return a.seq < b.seq;
+		}
+	};
+
+	static constexpr size_t no_limit = std::numeric_limits<size_t>::max();
+
+	iterable<IteratorType> src_;
+	KeyFunc key_;
+	size_t limit_;
+	std::shared_ptr<buffer_type> buf_;
+
+	static container_type sort(iterable<IteratorType> const& src, KeyFunc key, size_t const& limit) {
+		std::vector<entry> entries;
+		entry_less less;
+		size_t seq = 0;
+
+		if (limit == no_limit) {
+			size_estimate const hint = src.size_hint();
+			if (hint.is_exact()) entries.reserve(hint.value);
+			src.for_each([&](value_type const& v) {
+				entries.push_back(entry{ key(v), seq++, v });
+			});
+			std::sort(entries.begin(), entries.end(), less);
+		}
+		else if (limit) {
+			// Max-heap of the best limit elements seen so far; the worst one is on
+			// top. A later element with an equal key never replaces it.
+			entries.reserve(limit);
+			src.for_each([&](value_type const& v) {
+				if (entries.size() < limit) {
+					entries.push_back(entry{ key(v), seq++, v });
+					std::push_heap(entries.begin(), entries.end(), less);
+					return;
+				}
+				key_type k = key(v);
+				++seq;
+				if (!less.comp(k, entries.front().key)) return;
+				std::pop_heap(entries.begin(), entries.end(), less);
+				entries.back() = entry{ std::move(k), seq - 1, v };
+				std::push_heap(entries.begin(), entries.end(), less);
+			});
+			std::sort_heap(entries.begin(), entries.end(), less);
+		}
+
+		container_type ret;
+		ret.reserve(entries.size());
+		for (auto& e : entries) ret.push_back(std::move(e.value));
+		return ret;
+	}
+
+	static std::shared_ptr<buffer_type> make_buffer(iterable<IteratorType> const& src, KeyFunc const& key, size_t const& limit) {
+		return std::make_shared<buffer_type>([src, key, limit]() { return sort(src, key, limit); });
+	}
+
+	ordered_iterable(iterable<IteratorType> const& src, KeyFunc const& key, size_t const& limit,
+		std::shared_ptr<buffer_type> const& buf)
+		: base_t(iterator(buf, 0), iterator(buf, iterator::at_end)), src_(src), key_(key), limit_(limit), buf_(buf) {}
+
+public:
+	ordered_iterable() = delete;
+	ordered_iterable(ordered_iterable const&) = default;
+	ordered_iterable(ordered_iterable&&) = default;
+
+	ordered_iterable(iterable<IteratorType> const& src, KeyFunc const& key, size_t const& limit = no_limit)
+		: ordered_iterable(src, key, limit, make_buffer(src, key, limit)) {}
+
+	ordered_iterable take(size_t const& count) const {
+		return ordered_iterable(src_, key_, std::min(count, limit_));
+	}
+
+	value_type first() const {
+		return *(take(1).begin());
+	}
+
+	std::vector<value_type> to_vector() const {
+		return buf_->is_sorted()? buf_->get() : sort(src_, key_, limit_);
+	}
+};
+
+template <typename IteratorType, typename KeyFunc, bool Descending>
+constexpr size_t ordered_iterable<IteratorType, KeyFunc, Descending>::no_limit;
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_ORDERED_ITERABLE_HPP__
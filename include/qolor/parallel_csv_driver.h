@@ -0,0 +1,379 @@
+#ifndef QOLOR_PARALLEL_CSV_DRIVER_H__
+#define QOLOR_PARALLEL_CSV_DRIVER_H__
+
+#include "mapped_csv_driver.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qolor
+{
+
+// Order of the rows of a parallel scan.
+enum class row_order
+{
+	source, // the order of the file
+	any     // as soon as they are parsed
+};
+
+namespace internal
+{
+
+namespace csv
+{
+
+// Parses a memory-mapped file on several threads. The file is split into
+// chunks of chunk_size bytes, and a chunk holds the rows that start in it.
+// Worker threads take the chunks in order and parse them into batches, which
+// the consumer reads either in the order of the chunks or as they are done.
+//
+// A worker starts at the first newline of its chunk that is not inside quotes.
+// The quote state at the start of chunk c is the parity of the quotes before
+// it: the worker that takes a chunk counts the quotes of the chunks taken
+// since the last one, which is much cheaper than parsing them, so the
+// chunks can be parsed independently without reading the file twice ahead of
+// time. This assumes that quotes only appear in quoted fields, as in RFC 4180.
+//
+// At most max_in_flight chunks are parsed or waiting for the consumer, which
+// bounds the memory of the scan. Batches are reused.
+class parallel_csv_state
+{
+public:
+	static constexpr size_t default_chunk_size = 1 << 20;
+
+private:
+	struct row_batch
+	{
+		struct row_start
+		{
+			size_t field;
+			size_t scratch;
+		};
+
+		size_t chunk;
+		std::vector<field_span> fields;
+		std::string scratch;
+		std::vector<row_start> rows; // plus one past the last row
+
+		size_t num_rows() const { return rows.empty()? 0 : rows.size() - 1; }
+
+		void clear() {
+			fields.clear();
+			scratch.clear();
+			rows.clear();
+		}
+	};
+
+	std::shared_ptr<utils::mapped_file const> file_;
+	char sep_;
+	row_order order_;
+	size_t num_threads_;
+	size_t chunk_size_;
+	size_t num_chunks_;
+	size_t max_in_flight_;
+	std::vector<size_t> projection_; // see columns; empty for all columns
+	field_filter filter_;
+	size_t header_end_;              // rows start after the header, if any
+	std::vector<std::thread> threads_;
+
+	std::mutex mutex_;
+	std::condition_variable ready_; // a batch is done, or the workers stopped
+	std::condition_variable space_; // a batch was consumed
+	size_t next_chunk_;             // next chunk for the workers
+	size_t counted_chunk_;          // chunk at which quotes_ is the quote state
+	uint64_t quotes_;
+	size_t delivered_;              // batches handed to the consumer
+	size_t running_;                // workers still running
+	std::vector<std::unique_ptr<row_batch>> done_;
+	std::vector<std::unique_ptr<row_batch>> free_;
+	std::exception_ptr error_;
+	bool cancelled_;
+	bool started_;
+
+	// Read by the consumer only.
+	std::unique_ptr<row_batch> batch_;
+	size_t row_index_;
+	mapped_row row_;
+	bool row_ready_;
+
+	size_t chunk_begin(size_t const& c) const { return std::min(c * chunk_size_, file_->size()); }
+
+	// Counts the quotes of the chunks before c. Needs the lock.
+	uint64_t quote_state(size_t const& c) {
+		char const* data = file_->data();
+		for (; counted_chunk_ < c; ++counted_chunk_) {
+			size_t const b = chunk_begin(counted_chunk_);
+			size_t const n = chunk_begin(counted_chunk_ + 1) - b;
+			if (simd::count(data + b, n, '"') & 1) quotes_ = ~quotes_;
+		}
+		return quotes_;
+	}
+
+	void parse(size_t const& c, uint64_t in_quotes, row_batch& batch) const {
+		char const* data = file_->data();
+		size_t const size = file_->size();
+		size_t const b = chunk_begin(c);
+		size_t const e = chunk_begin(c + 1);
+
+		// The chunk is parsed from the byte before it, so that a row that
+		// starts right at b follows a newline.
+		row_parser parser;
+		if (c == 0)
+			parser = row_parser(data, size, sep_);
+		else {
+			if (data[b - 1] == '"') in_quotes = ~in_quotes;
+			parser = row_parser(data, size, sep_, b - 1, in_quotes);
+			parser.skip_line();
+		}
+		// Rows always start outside quotes.
+		if (parser.pos() < header_end_) parser = row_parser(data, size, sep_, header_end_);
+		if (!projection_.empty()) parser.project(projection_);
+		parser.filter(filter_);
+
+		batch.chunk = c;
+		row_batch::row_start r = { 0, 0 };
+		batch.rows.push_back(r);
+		while (parser.next_row(batch.fields, batch.scratch, e)) {
+			r.field = batch.fields.size();
+			r.scratch = batch.scratch.size();
+			batch.rows.push_back(r);
+		}
+	}
+
+	void work() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;) {
+			space_.wait(lock, [this]() {
+				return cancelled_ || next_chunk_ >= num_chunks_ || next_chunk_ < delivered_ + max_in_flight_;
+			});
+			if (cancelled_ || next_chunk_ >= num_chunks_) break;
+
+			size_t const c = next_chunk_++;
+			uint64_t const in_quotes = quote_state(c);
+			std::unique_ptr<row_batch> batch;
+			if (free_.empty()) batch.reset(new row_batch());
+			else { batch = std::move(free_.back()); free_.pop_back(); }
+
+			lock.unlock();
+			try {
+				batch->clear();
+				parse(c, in_quotes, *batch);
+			}
+			catch (...) {
+				lock.lock();
+				if (!error_) error_ = std::current_exception();
+				cancelled_ = true;
+				break;
+			}
+			lock.lock();
+			done_.push_back(std::move(batch));
+			ready_.notify_all();
+		}
+		--running_;
+		ready_.notify_all();
+		space_.notify_all();
+	}
+
+	// Waits for the next batch; null at the end of the file.
+	std::unique_ptr<row_batch> next_batch() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (batch_) {
+			free_.push_back(std::move(batch_));
+			space_.notify_all();
+		}
+		if (!started_) {
+			started_ = true;
+			running_ = num_threads_;
+			for (size_t i = 0; i < num_threads_; ++i)
+				threads_.emplace_back([this]() { work(); });
+		}
+
+		std::unique_ptr<row_batch> ret;
+		for (;;) {
+			if (error_) {
+				std::exception_ptr e = error_;
+				error_ = nullptr;
+				std::rethrow_exception(e);
+			}
+			if (delivered_ >= num_chunks_) return ret;
+
+			auto it = done_.end();
+			if (order_ == row_order::any) {
+				if (!done_.empty()) it = done_.end() - 1;
+			}
+			else {
+				it = std::find_if(done_.begin(), done_.end(),
+					[this](std::unique_ptr<row_batch> const& b) { return b->chunk == delivered_; });
+			}
+
+			if (it != done_.end()) {
+				ret = std::move(*it);
+				done_.erase(it);
+				++delivered_;
+				space_.notify_all();
+				return ret;
+			}
+			if (cancelled_ && !running_) return ret;
+			ready_.wait(lock);
+		}
+	}
+
+public:
+	parallel_csv_state(std::shared_ptr<utils::mapped_file const> const& file, char const& sep,
+		size_t const& num_threads, row_order const& order, size_t chunk_size = default_chunk_size)
+		: file_(file), sep_(sep), order_(order),
+		num_threads_(num_threads? num_threads : std::max(1u, std::thread::hardware_concurrency())),
+		chunk_size_(std::max<size_t>(1, chunk_size)), num_chunks_((file->size() + chunk_size_ - 1) / chunk_size_),
+		max_in_flight_(2 * num_threads_ + 2), header_end_(0), next_chunk_(0), counted_chunk_(0), quotes_(0),
+		delivered_(0), running_(0), cancelled_(false), started_(false), row_index_(0), row_ready_(false) {
+		row_.data_ = file->data();
+	}
+
+	// Reads the given columns only; see columns.
+	parallel_csv_state(std::shared_ptr<utils::mapped_file const> const& file, char const& sep,
+		size_t const& num_threads, row_order const& order, columns const& cols, size_t chunk_size = default_chunk_size)
+		: parallel_csv_state(file, sep, num_threads, order, chunk_size) {
+		if (cols.by_name()) {
+			row_parser parser(file->data(), file->size(), sep);
+			parser.next_row(row_.fields_, row_.scratch_);
+			header_end_ = parser.pos();
+		}
+		projection_ = cols.resolve(row_);
+		row_.clear();
+	}
+
+	// Reads the rows that meet filter only; see field_filter.
+	parallel_csv_state(std::shared_ptr<utils::mapped_file const> const& file, char const& sep, size_t const& num_threads,
+		row_order const& order, columns const& cols, field_filter const& filter, size_t chunk_size = default_chunk_size)
+		: parallel_csv_state(file, sep, num_threads, order, cols, chunk_size) {
+		filter_ = filter;
+	}
+
+	parallel_csv_state(parallel_csv_state const&) = delete;
+	parallel_csv_state& operator=(parallel_csv_state const&) = delete;
+
+	~parallel_csv_state() {
+		{
+			std::lock_guard<std::mutex> g(mutex_);
+			cancelled_ = true;
+		}
+		space_.notify_all();
+		for (auto& t : threads_) t.join();
+	}
+
+	// Waits until the row at the read position is parsed. Returns false at
+	// the end of the file.
+	bool available() {
+		while (!batch_ || row_index_ >= batch_->num_rows()) {
+			batch_ = next_batch();
+			row_index_ = 0;
+			row_ready_ = false;
+			if (!batch_) return false;
+		}
+		return true;
+	}
+
+	mapped_row const& current() {
+		if (!row_ready_) {
+			// Fields in the scratch buffer of the batch move to the one of the row.
+			row_batch::row_start const& b = batch_->rows[row_index_];
+			row_batch::row_start const& e = batch_->rows[row_index_ + 1];
+			row_.fields_.assign(batch_->fields.begin() + b.field, batch_->fields.begin() + e.field);
+			row_.scratch_.assign(batch_->scratch, b.scratch, e.scratch - b.scratch);
+			if (e.scratch != b.scratch)
+				for (auto& f : row_.fields_) if (f.in_scratch) f.offset -= b.scratch;
+			row_ready_ = true;
+		}
+		return row_;
+	}
+
+	void advance() {
+		++row_index_;
+		row_ready_ = false;
+	}
+};
+
+
+class parallel_csv_iterator
+{
+private:
+	std::shared_ptr<parallel_csv_state> state_; // null in the end iterator
+
+	bool at_end() const { return !state_ || !state_->available(); }
+
+public:
+	typedef std::ptrdiff_t difference_type;
+	typedef mapped_row value_type;
+	typedef mapped_row const& reference;
+	typedef mapped_row const* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+	parallel_csv_iterator() = default;
+	parallel_csv_iterator(parallel_csv_iterator const&) = default;
+	parallel_csv_iterator(parallel_csv_iterator&&) = default;
+	parallel_csv_iterator& operator=(parallel_csv_iterator const&) = default;
+	parallel_csv_iterator& operator=(parallel_csv_iterator&&) = default;
+
+	explicit parallel_csv_iterator(std::shared_ptr<parallel_csv_state> const& state) : state_(state) {}
+
+	parallel_csv_iterator& operator++() {
+		if (state_->available()) state_->advance();
+		return *this;
+	}
+
+	bool operator==(parallel_csv_iterator const& o) const { return at_end() == o.at_end(); }
+	bool operator!=(parallel_csv_iterator const& o) const { return at_end() != o.at_end(); }
+
+	reference operator*() const { state_->available(); return state_->current(); }
+	pointer operator->() const { state_->available(); return &state_->current(); }
+};
+
+} // namespace csv
+
+} // namespace internal
+
+
+// Like from_csv_file, with the file parsed on num_threads threads (zero for
+// one per core). With row_order::any, rows come in the order their chunks of
+// the file are done.
+inline internal::iterable<internal::csv::parallel_csv_iterator>
+from_csv_file_parallel(std::string const& path, size_t const& num_threads = 0,
+	row_order const& order = row_order::source, char const& field_sep = ',')
+{
+	typedef internal::csv::parallel_csv_iterator iter_t;
+	std::shared_ptr<utils::mapped_file const> file = std::make_shared<utils::mapped_file>(path);
+	auto state = std::make_shared<internal::csv::parallel_csv_state>(file, field_sep, num_threads, order);
+	return internal::iterable<iter_t>(iter_t(state), iter_t());
+}
+
+// Reads the given columns only; see columns.
+inline internal::iterable<internal::csv::parallel_csv_iterator>
+from_csv_file_parallel(std::string const& path, columns const& cols, size_t const& num_threads = 0,
+	row_order const& order = row_order::source, char const& field_sep = ',')
+{
+	typedef internal::csv::parallel_csv_iterator iter_t;
+	std::shared_ptr<utils::mapped_file const> file = std::make_shared<utils::mapped_file>(path);
+	auto state = std::make_shared<internal::csv::parallel_csv_state>(file, field_sep, num_threads, order, cols);
+	return internal::iterable<iter_t>(iter_t(state), iter_t());
+}
+
+// Reads the rows that meet filter only; the workers check it on the bytes of
+// the file, so rejected rows are never copied to the consumer.
+inline internal::iterable<internal::csv::parallel_csv_iterator>
+from_csv_file_parallel(std::string const& path, columns const& cols, field_filter const& filter,
+	size_t const& num_threads = 0, row_order const& order = row_order::source, char const& field_sep = ',')
+{
+	typedef internal::csv::parallel_csv_iterator iter_t;
+	std::shared_ptr<utils::mapped_file const> file = std::make_shared<utils::mapped_file>(path);
+	auto state = std::make_shared<internal::csv::parallel_csv_state>(file, field_sep, num_threads, order, cols, filter);
+	return internal::iterable<iter_t>(iter_t(state), iter_t());
+}
+
+} // namespace qolor
+
+#endif // QOLOR_PARALLEL_CSV_DRIVER_H__
@@ -0,0 +1,213 @@
+#ifndef QOLOR_PARALLEL_ITERABLE_HPP__
+#define QOLOR_PARALLEL_ITERABLE_HPP__
+
+#include "basic_iterable.h"
+#include "fused_chain.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// Runs func(0) ... func(num_chunks - 1) on num_threads threads (the calling
+// thread included). Idle threads pick the next pending chunk, so threads that
+// got cheap chunks keep taking work from the ones that got expensive chunks.
+// The first exception thrown by func is rethrown in the calling thread.
+template <typename Func>
+void run_chunks(size_t num_threads, size_t const& num_chunks, Func&& func)
+{
+	std::atomic<size_t> next(0);
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	auto worker = [&]() {
+		size_t c;
+		while ((c = next++) < num_chunks) {
+			try { func(c); }
+			catch (...) {
+				std::lock_guard<std::mutex> g(error_mutex);
+				if (!error) error = std::current_exception();
+				next = num_chunks;
+			}
+		}
+	};
+
+	if (num_threads > num_chunks) num_threads = num_chunks;
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < num_threads; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& t : threads) t.join();
+
+	if (error) std::rethrow_exception(error);
+}
+
+
+template <typename IteratorType>
+class parallel_iterable
+{
+public:
+	typedef IteratorType iterator;
+	typedef typename iterable<IteratorType>::value_type value_type;
+
+private:
+	typedef fused_chain<IteratorType> chain;
+	typedef typename chain::base_iterator base_iterator;
+	typedef typename std::iterator_traits<base_iterator>::iterator_category base_category;
+
+	static_assert(chain::is_splittable, "take() and take_while() cannot run in parallel.");
+	static_assert(std::is_same<base_category, std::random_access_iterator_tag>::value,
+		"Parallel execution needs a random access source.");
+
+	iterable<IteratorType> src_;
+	size_t num_threads_;
+
+	// Splits the source in chunks and runs the chain over chunk c with the
+	// sink returned by make_sink(c).
+	template <typename MakeSink>
+	void run(MakeSink&& make_sink) const {
+		base_iterator const& b = chain::base(src_.begin());
+		base_iterator const& e = chain::base(src_.end());
+		size_t const size = (b < e)? (e - b) : 0;
+		size_t const n = num_chunks();
+
+		run_chunks(num_threads_, n, [&](size_t const& c) {
+			auto sink = make_sink(c);
+			chain::run(src_.begin(), b + (c * size / n), b + ((c + 1) * size / n), sink);
+		});
+	}
+
+	size_t num_chunks() const {
+		base_iterator const& b = chain::base(src_.begin());
+		base_iterator const& e = chain::base(src_.end());
+		size_t const size = (b < e)? (e - b) : 0;
+		size_t const n = 4 * num_threads_;
+		return std::max<size_t>(1, std::min(size, n));
+	}
+
+	template <typename F>
+	struct aggregate_sink
+	{
+		F func_;
+		value_type* acc_;
+		bool* has_value_;
+
+		template <typename T>
+		bool operator()(T&& v) {
+			if (*has_value_) *acc_ = func_(*acc_, std::forward<T>(v));
+			else { *acc_ = std::forward<T>(v); *has_value_ = true; }
+			return true;
+		}
+	};
+
+	struct append_sink
+	{
+		std::vector<value_type>* out_;
+
+		template <typename T>
+		bool operator()(T&& v) { out_->push_back(std::forward<T>(v)); return true; }
+	};
+
+	struct contains_sink
+	{
+		value_type const* value_;
+		std::atomic<bool>* found_;
+
+		template <typename T>
+		bool operator()(T&& v) {
+			if (*value_ == v) *found_ = true;
+			return !found_->load(std::memory_order_relaxed);
+		}
+	};
+
+public:
+	parallel_iterable() = delete;
+	parallel_iterable(parallel_iterable const&) = default;
+	parallel_iterable(parallel_iterable&&) = default;
+
+	parallel_iterable(iterable<IteratorType> const& src, size_t const& num_threads)
+		: src_(src), num_threads_(num_threads? num_threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+	size_t const& num_threads() const { return num_threads_; }
+	iterable<IteratorType> const& sequential() const { return src_; }
+
+	template <typename F>
+	parallel_iterable<select_iterator<iterator, F>> select(F&& f) {
+		return parallel_iterable<select_iterator<iterator, F>>(src_.select(std::forward<F>(f)), num_threads_);
+	}
+
+	template <typename F>
+	parallel_iterable<where_iterator<iterator, typename std::decay<F>::type>> where(F&& f) {
+		typedef where_iterator<iterator, typename std::decay<F>::type> iter_t;
+		return parallel_iterable<iter_t>(src_.where(std::forward<F>(f)), num_threads_);
+	}
+
+	// f must be associative. Partial results are combined in source order.
+	template <typename F>
+	value_type aggregate(F&& f) const {
+		typedef typename std::decay<F>::type ftype;
+		size_t const n = num_chunks();
+		std::vector<value_type> partial(n);
+		std::unique_ptr<bool[]> has_value(new bool[n]());
+
+		run([&](size_t const& c) {
+			aggregate_sink<ftype> s = { f, &partial[c], &has_value[c] };
+			return s;
+		});
+
+		value_type acc = value_type();
+		bool has_acc = false;
+		for (size_t c = 0; c < n; ++c) {
+			if (!has_value[c]) continue;
+			if (has_acc) acc = f(acc, partial[c]);
+			else { acc = std::move(partial[c]); has_acc = true; }
+		}
+		return acc;
+	}
+
+	value_type sum() const {
+		typedef value_type const& ref;
+		return aggregate([](ref a, ref b){ return a + b; });
+	}
+
+	std::vector<value_type> to_vector() const {
+		size_t const n = num_chunks();
+		std::vector<std::vector<value_type>> parts(n);
+
+		run([&](size_t const& c) {
+			append_sink s = { &parts[c] };
+			return s;
+		});
+
+		size_t total = 0;
+		for (auto const& p : parts) total += p.size();
+		std::vector<value_type> ret;
+		ret.reserve(total);
+		for (auto& p : parts)
+			std::move(p.begin(), p.end(), std::back_inserter(ret));
+		return ret;
+	}
+
+	bool contains(value_type const& value) const {
+		std::atomic<bool> found(false);
+		run([&](size_t const&) {
+			contains_sink s = { &value, &found };
+			return s;
+		});
+		return found;
+	}
+};
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_PARALLEL_ITERABLE_HPP__
@@ -28,7 +28,7 @@ public:
 
 	mutable inner_type cur_;
 	inner_type end_;
-	pred_type pred_;
+	qolor::utils::optional_value<pred_type> pred_; // empty in end iterators
 	mutable bool started_;
 
 	generic_predicate_iterator() = delete;
@@ -39,6 +39,15 @@ public:
 	generic_predicate_iterator(B&& b, E&& e, P&& p)
 	: cur_(std::forward<B>(b)), end_(std::forward<E>(e)), pred_(std::forward<P>(p)), started_(false) {}
 
+	// End iterator: it only marks the end, so it does not carry the predicate.
+	template <typename E>
+	generic_predicate_iterator(E&& e, qolor::utils::generic_end_iterator const&)
+	: cur_(e), end_(std::forward<E>(e)), started_(true) {}
+
+	bool is_end() const { return !pred_; }
+	pred_type& pred() { return *pred_; }
+	pred_type const& pred() const { return *pred_; }
+
 	typedef typename inner_traits::difference_type difference_type;
 	typedef typename inner_traits::value_type value_type;
 	typedef typename inner_traits::reference reference;
@@ -59,11 +68,16 @@ private:
 	typedef generic_predicate_iterator<InnerType,Pred> base_t;
 
 	void ignite() const {
-		while ((base_t::cur_ != base_t::end_) && !base_t::pred_(*base_t::cur_))
+		while ((base_t::cur_ != base_t::end_) && !base_t::pred()(*base_t::cur_))
 			++base_t::cur_;
 		base_t::started_ = true;
 	}
 
+	bool at_end() const {
+		if (!base_t::started_) ignite();
+		return base_t::cur_ == base_t::end_;
+	}
+
 public:
 	typedef typename base_t::difference_type difference_type;
 	typedef typename base_t::value_type value_type;
@@ -79,11 +93,15 @@ public:
 	where_iterator(BeginIter&& b, EndIter&& e, Predicate&& p)
 	: base_t(std::forward<BeginIter>(b), std::forward<EndIter>(e), std::forward<Predicate>(p)) {}
 
+	template <typename EndIter>
+	where_iterator(EndIter&& e, qolor::utils::generic_end_iterator const& g)
+	: base_t(std::forward<EndIter>(e), g) {}
+
 	where_iterator & operator++() {
 		if (!base_t::started_) ignite();
 		do
 			++base_t::cur_;
-		while (base_t::cur_ != base_t::end_ && !base_t::pred_(*base_t::cur_));
+		while (base_t::cur_ != base_t::end_ && !base_t::pred()(*base_t::cur_));
 		return *this;
 	}
 
@@ -94,6 +112,8 @@ public:
 	}
 
 	bool operator==(where_iterator const& o) const {
+		if (o.is_end()) return at_end();
+		if (base_t::is_end()) return o.at_end();
 		if (!base_t::started_) ignite();
 		if (!((const base_t&)o).started_) o.ignite();
 		return base_t::cur_ == o.cur_;
@@ -141,11 +161,16 @@ private:
 	typedef generic_predicate_iterator<InnerType,Pred> base_t;
 
 	void ignite() const {
-		if ((base_t::cur_ != base_t::end_) && !base_t::pred_(*base_t::cur_))
+		if ((base_t::cur_ != base_t::end_) && !base_t::pred()(*base_t::cur_))
 			base_t::cur_ = base_t::end_;
 		base_t::started_ = true;
 	}
 
+	bool at_end() const {
+		if (!base_t::started_) ignite();
+		return base_t::cur_ == base_t::end_;
+	}
+
 public:
 	typedef typename base_t::difference_type difference_type;
 	typedef typename base_t::value_type value_type;
@@ -161,10 +186,14 @@ public:
 	while_iterator(BeginIter&& b, EndIter&& e, Predicate&& p)
 	: base_t(std::forward<BeginIter>(b), std::forward<EndIter>(e), std::forward<Predicate>(p)) {}
 
+	template <typename EndIter>
+	while_iterator(EndIter&& e, qolor::utils::generic_end_iterator const& g)
+	: base_t(std::forward<EndIter>(e), g) {}
+
 	while_iterator & operator++() {
 		if (!base_t::started_) ignite();
 		++base_t::cur_;
-		if ((base_t::cur_ != base_t::end_) && !base_t::pred_(*base_t::cur_))
+		if ((base_t::cur_ != base_t::end_) && !base_t::pred()(*base_t::cur_))
 			base_t::cur_ = base_t::end_;
 		return *this;
 	}
@@ -176,6 +205,8 @@ public:
 	}
 
 	bool operator==(while_iterator const& o) const {
+		if (o.is_end()) return at_end();
+		if (base_t::is_end()) return o.at_end();
 		if (!base_t::started_) ignite();
 		if (!((const base_t&)o).started_) o.ignite();
 		return base_t::cur_ == o.cur_;
@@ -216,6 +247,26 @@ public:
 }; // class while_iterator
 
 
+// Predicate of take(): true for the first n_ elements. The iterators call
+// their predicate from const members, hence the mutable counter.
+template <typename ValueType>
+struct count_predicate
+{
+	mutable size_t n_;
+	count_predicate() = delete;
+	count_predicate(count_predicate const&) = default;
+	count_predicate(count_predicate&&) = default;
+	count_predicate& operator=(count_predicate const&) = default;
+	count_predicate(size_t const& n) : n_(n) {}
+
+	bool operator() (ValueType const&) const {
+		if (!n_) return false;
+		--n_;
+		return true;
+	}
+};
+
+
 } // namespace internal
 
 } // namespace qolor
@@ -0,0 +1,227 @@
+#ifndef QOLOR_PREFETCH_ITERATOR_HPP__
+#define QOLOR_PREFETCH_ITERATOR_HPP__
+
+#include "basic_iterable.h"
+#include "fused_chain.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+// Runs a query on a producer thread, which writes its elements into a
+// single-producer/single-consumer ring buffer that the consumer reads from.
+// Both sides publish their position once per batch, so they rarely touch the
+// cache lines of each other. A side that has to wait for the other spins
+// briefly, then sleeps until the other one publishes its position. An
+// exception thrown by the query is rethrown to the consumer once it has read
+// everything produced before it.
+template <typename IteratorType>
+class prefetch_state
+{
+public:
+	typedef typename iterable<IteratorType>::value_type value_type;
+
+	static_assert(std::is_default_constructible<value_type>::value, "value_type must be default constructible.");
+
+private:
+	typedef fused_chain<IteratorType> chain;
+
+	iterable<IteratorType> src_;
+	std::vector<value_type> slots_;
+	size_t mask_;
+	size_t batch_;
+	std::thread thread_;
+	std::exception_ptr error_;
+
+	// Written by the producer.
+	alignas(64) std::atomic<size_t> tail_;
+	std::atomic<bool> done_;
+	size_t write_, head_cache_;
+
+	// Written by the consumer.
+	alignas(64) std::atomic<size_t> head_;
+	std::atomic<bool> cancelled_;
+	size_t read_, tail_cache_;
+	bool started_;
+
+	// Either side, once it has spun for spins rounds without the other one
+	// moving, sleeps on wakeup_.
+	static constexpr int spins = 64;
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	std::atomic<int> sleepers_;
+
+	// Waits until ready(), which reads the positions of the other side.
+	template <typename Ready>
+	void wait(Ready&& ready) {
+		for (int i = 0; i < spins; ++i) {
+			if (ready()) return;
+			std::this_thread::yield();
+		}
+		std::unique_lock<std::mutex> lock(mutex_);
+		sleepers_.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		wakeup_.wait(lock, ready);
+		sleepers_.fetch_sub(1);
+	}
+
+	// Wakes the other side after a position is published. The fences order
+	// the position and sleepers_, so that either the sleeper sees the
+	// position, or this sees the sleeper (who holds mutex_ until it waits).
+	void wake() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleepers_.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			wakeup_.notify_all();
+		}
+	}
+
+	struct producer_sink
+	{
+		prefetch_state* s_;
+
+		template <typename T>
+		bool operator()(T&& v) { return s_->put(std::forward<T>(v)); }
+	};
+
+	template <typename T>
+	bool put(T&& v) {
+		if (write_ - head_cache_ > mask_) {
+			tail_.store(write_, std::memory_order_release);
+			wake();
+			wait([this]() {
+				return write_ - (head_cache_ = head_.load(std::memory_order_acquire)) <= mask_
+					|| cancelled_.load(std::memory_order_relaxed);
+			});
+			if (cancelled_.load(std::memory_order_relaxed)) return false;
+		}
+		slots_[write_ & mask_] = std::forward<T>(v);
+		if ((++write_ & (batch_ - 1)) == 0) {
+			tail_.store(write_, std::memory_order_release);
+			wake();
+			return !cancelled_.load(std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	void produce() {
+		try {
+			producer_sink s = { this };
+			chain::run(src_.begin(), chain::base(src_.begin()), chain::base(src_.end()), s);
+		}
+		catch (...) {
+			error_ = std::current_exception();
+		}
+		tail_.store(write_, std::memory_order_release);
+		done_.store(true, std::memory_order_release);
+		wake();
+	}
+
+public:
+	prefetch_state(iterable<IteratorType> const& src, size_t const& capacity)
+		: src_(src), mask_(0), batch_(1), tail_(0), done_(false), write_(0), head_cache_(0),
+		head_(0), cancelled_(false), read_(0), tail_cache_(0), started_(false), sleepers_(0) {
+		size_t n = 2;
+		while (n < capacity) n *= 2;
+		slots_.resize(n);
+		mask_ = n - 1;
+		while (batch_ * 8 < n) batch_ *= 2;
+	}
+
+	prefetch_state(prefetch_state const&) = delete;
+	prefetch_state& operator=(prefetch_state const&) = delete;
+
+	~prefetch_state() {
+		cancelled_ = true;
+		wake();
+		if (thread_.joinable()) thread_.join();
+	}
+
+	// Waits until the element at the read position is produced. Returns false
+	// at the end of the query.
+	bool available() {
+		if (read_ != tail_cache_) return true;
+		if (!started_) {
+			started_ = true;
+			thread_ = std::thread([this]() { produce(); });
+		}
+		head_.store(read_, std::memory_order_release);
+		wake();
+		wait([this]() {
+			bool const done = done_.load(std::memory_order_acquire);
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			return read_ != tail_cache_ || done;
+		});
+		if (read_ != tail_cache_) return true;
+		if (error_) {
+			std::exception_ptr e = error_;
+			error_ = nullptr;
+			std::rethrow_exception(e);
+		}
+		return false;
+	}
+
+	value_type& current() { return slots_[read_ & mask_]; }
+
+	void advance() {
+		if ((++read_ & (batch_ - 1)) == 0) {
+			head_.store(read_, std::memory_order_release);
+			wake();
+		}
+	}
+};
+
+
+template <typename IteratorType>
+class prefetch_iterator
+{
+private:
+	typedef prefetch_state<IteratorType> state_type;
+
+	std::shared_ptr<state_type> state_; // null in the end iterator
+
+	bool at_end() const { return !state_ || !state_->available(); }
+
+public:
+	typedef std::ptrdiff_t difference_type;
+	typedef typename state_type::value_type value_type;
+	typedef value_type& reference;
+	typedef value_type* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+	prefetch_iterator() = default;
+	prefetch_iterator(prefetch_iterator const&) = default;
+	prefetch_iterator(prefetch_iterator&&) = default;
+	prefetch_iterator& operator=(prefetch_iterator const&) = default;
+	prefetch_iterator& operator=(prefetch_iterator&&) = default;
+
+	explicit prefetch_iterator(std::shared_ptr<state_type> const& state) : state_(state) {}
+
+	prefetch_iterator& operator++() {
+		if (state_->available()) state_->advance();
+		return *this;
+	}
+
+	bool operator==(prefetch_iterator const& o) const { return at_end() == o.at_end(); }
+	bool operator!=(prefetch_iterator const& o) const { return at_end() != o.at_end(); }
+
+	reference operator*() const { state_->available(); return state_->current(); }
+	pointer operator->() const { state_->available(); return &state_->current(); }
+};
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_PREFETCH_ITERATOR_HPP__
@@ -81,10 +81,12 @@ class range_iterator
 {
 public:
 	using value_type = typename std::decay<NumT>::type;
-	using difference_type = value_type;
-	using reference = value_type const&;
+	using difference_type = std::ptrdiff_t;
+	// Values are computed, so they are returned by value: a reference into
+	// the iterator would dangle once the iterator is gone (e.g. in last()).
+	using reference = value_type;
 	using pointer = value_type const*;
-	using iterator_category = std::input_iterator_tag;
+	using iterator_category = std::random_access_iterator_tag;
 
 private:
 
@@ -130,18 +132,29 @@ public:
 	bool operator<=(value_type const& o) const { return value_ <= o; }
 	bool operator>=(value_type const& o) const { return value_ >= o; }
 
+	// Number of steps from o to this iterator, rounded for floating point ranges.
+	difference_type operator-(range_iterator const& o) const {
+		if (value_ < o.value_) return -(o - *this);
+		value_type const n = (value_ - o.value_) / step_;
+		if (std::is_integral<value_type>::value) return difference_type(n);
+		return difference_type(std::floor(n + value_type(0.5)));
+	}
+
+	// Iterators are ordered by position, which is the reverse of the values
+	// for negative steps.
 	bool operator==(range_iterator const& o) const { return  eq_(value_, o.value_); }
 	bool operator!=(range_iterator const& o) const { return !eq_(value_, o.value_); }
-	bool operator< (range_iterator const& o) const { return value_ <  o.value_; }
-	bool operator> (range_iterator const& o) const { return value_ >  o.value_; }
-	bool operator<=(range_iterator const& o) const { return value_ <= o.value_; }
-	bool operator>=(range_iterator const& o) const { return value_ >= o.value_; }
+	bool operator< (range_iterator const& o) const { return (o - *this) >  0; }
+	bool operator> (range_iterator const& o) const { return (o - *this) <  0; }
+	bool operator<=(range_iterator const& o) const { return (o - *this) >= 0; }
+	bool operator>=(range_iterator const& o) const { return (o - *this) <= 0; }
 
 	reference operator*() const { return value_; }
 	value_type operator[](difference_type const& n) const { return std::move(value_ + n * step_); }
 	pointer operator->() const { return &value_; }
 };
 
+
 } // namespace internal
 
 
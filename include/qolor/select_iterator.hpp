@@ -20,17 +20,21 @@ private:
 	using inner_type = typename std::decay<InnerType>::type;
 	using func_type = typename std::decay<FuncType>::type;
 
-	inner_type cur_;
-	func_type func_;
+	// Dereferencing is const, but inner iterators (e.g. where_iterator) and
+	// functions may only dereference or be called as non-const.
+	mutable inner_type cur_;
+	mutable func_type func_;
 	
 public:
 	typedef typename std::iterator_traits<inner_type>::difference_type difference_type;
 	typedef typename std::decay<decltype(func_(*cur_))>::type value_type;
-	typedef typename std::add_rvalue_reference<value_type>::type reference;
+	// Mapped elements are computed, so they are returned by value.
+	typedef value_type reference;
 	typedef typename std::add_pointer<value_type>::type pointer;
-	typedef std::input_iterator_tag iterator_category;
+	// Mapping the elements does not change how the inner iterator moves.
+	typedef typename std::iterator_traits<inner_type>::iterator_category iterator_category;
 
-	select_iterator() = delete;
+	select_iterator() = default;
 	select_iterator(select_iterator const&) = default;
 	select_iterator(select_iterator&&) = default;
 
@@ -52,20 +56,29 @@ public:
 	select_iterator operator+(difference_type const& diff) const {
 		select_iterator ret(*this);
 		std::advance(ret.cur_, diff);
-		return std::move(ret);
+		return ret;
 	}
 
 	select_iterator operator-(difference_type const& diff) const {
 		select_iterator ret(*this);
 		std::advance(ret.cur_, -diff);
-		return std::move(ret);
+		return ret;
 	}
 
 	difference_type operator-(select_iterator const& other) const { return cur_ - other.cur_; }
-	value_type operator*() { return std::move(func_(*cur_)); }
 
-	std::unique_ptr<value_type> operator->() {
-		return std::unique_ptr<value_type>(new value_type(std::move(func_(*cur_))));
+	bool operator< (select_iterator const& o) const { return cur_ <  o.cur_; }
+	bool operator> (select_iterator const& o) const { return cur_ >  o.cur_; }
+	bool operator<=(select_iterator const& o) const { return cur_ <= o.cur_; }
+	bool operator>=(select_iterator const& o) const { return cur_ >= o.cur_; }
+
+	inner_type const& base() const { return cur_; }
+	func_type const& func() const { return func_; }
+	value_type operator*() const { return func_(*cur_); }
+	value_type operator[](difference_type const& n) const { return func_(cur_[n]); }
+
+	std::unique_ptr<value_type> operator->() const {
+		return std::unique_ptr<value_type>(new value_type(func_(*cur_)));
 	}
 };
 
@@ -0,0 +1,112 @@
+#ifndef QOLOR_SIMD_KERNELS_H__
+#define QOLOR_SIMD_KERNELS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace qolor
+{
+
+// Reduction and search kernels over contiguous arrays of arithmetic values.
+// Every kernel is compiled for several instruction sets and the best one
+// supported by the CPU is picked at run time. iterable uses them when its
+// source is a pointer range or a vector (or string) iterator range.
+namespace simd
+{
+
+enum class isa { scalar, sse2, avx2 };
+
+isa active_isa();
+char const* isa_name(isa const& i);
+
+// Value types with kernels.
+template <typename T>
+struct is_supported : std::integral_constant<bool,
+	std::is_same<T, char>::value || std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value ||
+	std::is_same<T, int16_t>::value || std::is_same<T, uint16_t>::value ||
+	std::is_same<T, int32_t>::value || std::is_same<T, uint32_t>::value ||
+	std::is_same<T, int64_t>::value || std::is_same<T, uint64_t>::value ||
+	std::is_same<T, float>::value || std::is_same<T, double>::value
+> {};
+
+// Iterators over contiguous memory with values of a supported type.
+template <typename Iter, typename Value, bool IsSupported = is_supported<typename std::remove_cv<Value>::type>::value>
+struct is_vectorizable : std::false_type {};
+
+template <typename Iter, typename Value>
+struct is_vectorizable<Iter, Value, true> : std::integral_constant<bool, std::is_pointer<Iter>::value
+	|| std::is_same<Iter, typename std::vector<Value>::iterator>::value
+	|| std::is_same<Iter, typename std::vector<Value>::const_iterator>::value
+	|| std::is_same<Iter, std::string::iterator>::value
+	|| std::is_same<Iter, std::string::const_iterator>::value
+> {};
+
+
+// Out of line kernels, for the types of is_supported.
+// sum() wraps around on integer overflow. Floating point sums are computed in
+// a different order than a sequential loop, so they may differ in the last
+// bits. min() and max() need n > 0. find() returns n when v is not found.
+namespace detail
+{
+	template <typename T> T sum(T const* p, size_t n);
+	template <typename T> T min(T const* p, size_t n);
+	template <typename T> T max(T const* p, size_t n);
+	template <typename T> size_t count(T const* p, size_t n, T v);
+	template <typename T> size_t find(T const* p, size_t n, T v);
+} // namespace detail
+
+// Shorter arrays are cheaper to handle inline than through the dispatch.
+static constexpr size_t inline_size = 16;
+
+template <typename T>
+T sum(T const* p, size_t const& n)
+{
+	if (n >= inline_size) return detail::sum(p, n);
+	T s = T();
+	for (size_t i = 0; i < n; ++i) s += p[i];
+	return s;
+}
+
+template <typename T>
+T min(T const* p, size_t const& n)
+{
+	if (n >= inline_size) return detail::min(p, n);
+	T m = p[0];
+	for (size_t i = 1; i < n; ++i) if (p[i] < m) m = p[i];
+	return m;
+}
+
+template <typename T>
+T max(T const* p, size_t const& n)
+{
+	if (n >= inline_size) return detail::max(p, n);
+	T m = p[0];
+	for (size_t i = 1; i < n; ++i) if (m < p[i]) m = p[i];
+	return m;
+}
+
+template <typename T>
+size_t count(T const* p, size_t const& n, T const& v)
+{
+	if (n >= inline_size) return detail::count(p, n, v);
+	size_t c = 0;
+	for (size_t i = 0; i < n; ++i) c += (p[i] == v);
+	return c;
+}
+
+template <typename T>
+size_t find(T const* p, size_t const& n, T const& v)
+{
+	if (n >= inline_size) return detail::find(p, n, v);
+	for (size_t i = 0; i < n; ++i) if (p[i] == v) return i;
+	return n;
+}
+
+} // namespace simd
+
+} // namespace qolor
+
+#endif // QOLOR_SIMD_KERNELS_H__
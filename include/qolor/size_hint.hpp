@@ -0,0 +1,110 @@
+#ifndef QOLOR_SIZE_HINT_HPP__
+#define QOLOR_SIZE_HINT_HPP__
+
+#include "select_iterator.hpp"
+#include "predicate_iterator.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace qolor
+{
+
+// What is known about the number of elements of an iterable without
+// iterating it.
+struct size_estimate
+{
+	enum kind_type { exact, upper_bound, unknown };
+
+	kind_type kind;
+	size_t value;
+
+	size_estimate() : kind(unknown), value(0) {}
+	size_estimate(kind_type const& k, size_t const& v) : kind(k), value(v) {}
+
+	bool is_exact() const { return kind == exact; }
+	bool is_known() const { return kind != unknown; }
+
+	// At most as many elements as this one.
+	size_estimate as_upper_bound() const {
+		return is_known()? size_estimate(upper_bound, value) : *this;
+	}
+
+	// At most n of the elements of this one.
+	size_estimate at_most(size_t const& n) const {
+		if (!is_known()) return size_estimate(upper_bound, n);
+		return size_estimate(kind, std::min(value, n));
+	}
+};
+
+namespace internal
+{
+
+// size_hint_of<Iter>::get(b, e) estimates the number of elements in [b, e),
+// looking through select/where/take layers down to the source.
+template <typename Iter, bool RandomAccess = std::is_same<
+	typename std::iterator_traits<Iter>::iterator_category, std::random_access_iterator_tag>::value>
+struct size_hint_of
+{
+	static size_estimate get(Iter const&, Iter const&) { return size_estimate(); }
+};
+
+template <typename Iter>
+struct size_hint_of<Iter, true>
+{
+	static size_estimate get(Iter const& b, Iter const& e) {
+		return size_estimate(size_estimate::exact, (b < e)? size_t(e - b) : 0);
+	}
+};
+
+template <typename InnerType, typename FuncType>
+struct size_hint_of<select_iterator<InnerType, FuncType>, false>
+{
+	typedef select_iterator<InnerType, FuncType> iter_t;
+	typedef size_hint_of<typename std::decay<InnerType>::type> inner;
+
+	static size_estimate get(iter_t const& b, iter_t const& e) { return inner::get(b.base(), e.base()); }
+};
+
+template <typename InnerType, typename Pred>
+struct size_hint_of<where_iterator<InnerType, Pred>, false>
+{
+	typedef where_iterator<InnerType, Pred> iter_t;
+	typedef size_hint_of<typename std::decay<InnerType>::type> inner;
+
+	static size_estimate get(iter_t const& b, iter_t const& e) {
+		return inner::get(b.cur_, e.cur_).as_upper_bound();
+	}
+};
+
+template <typename InnerType, typename Pred>
+struct size_hint_of<while_iterator<InnerType, Pred>, false>
+{
+	typedef while_iterator<InnerType, Pred> iter_t;
+	typedef size_hint_of<typename std::decay<InnerType>::type> inner;
+
+	static size_estimate get(iter_t const& b, iter_t const& e) {
+		return inner::get(b.cur_, e.cur_).as_upper_bound();
+	}
+};
+
+template <typename InnerType, typename ValueType>
+struct size_hint_of<while_iterator<InnerType, count_predicate<ValueType>>, false>
+{
+	typedef while_iterator<InnerType, count_predicate<ValueType>> iter_t;
+	typedef size_hint_of<typename std::decay<InnerType>::type> inner;
+
+	static size_estimate get(iter_t const& b, iter_t const& e) {
+		// Once started, the current element has already been counted.
+		size_t n = b.pred().n_;
+		if (b.started_ && b.cur_ != b.end_) ++n;
+		return inner::get(b.cur_, e.cur_).at_most(n);
+	}
+};
+
+} // namespace internal
+
+} // namespace qolor
+
+#endif // QOLOR_SIZE_HINT_HPP__
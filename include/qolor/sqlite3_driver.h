@@ -26,17 +26,24 @@
 #define SQLITE3PP_H
 
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iterator>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <sqlite3.h>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <qolor/step_iterator.h>
+#include <qolor/text_view.hpp>
 
 
 namespace qolor
@@ -79,6 +86,50 @@ public:
 };
 
 
+// Statements prepared once (as persistent ones) for their SQL text and kept
+// while they are among the capacity most recently used ones. A statement is
+// handed out again reset and with its bindings cleared; while it is still in
+// use, its SQL is prepared anew instead, without being cached. Statements
+// are reset when the last of their users is done with them.
+class statement_cache
+{
+public:
+	explicit statement_cache(size_t const& capacity = 0) : capacity_(capacity), hits_(0), misses_(0) {}
+	statement_cache(statement_cache const&) = delete;
+	statement_cache & operator=(statement_cache const&) = delete;
+
+	size_t capacity() const { return capacity_; }
+	size_t size() const { return lru_.size(); }
+	size_t hits() const { return hits_; }
+	size_t misses() const { return misses_; }
+
+	// Finalizes the least recently used statements beyond capacity.
+	void set_capacity(size_t const& capacity) { capacity_ = capacity; trim(); }
+
+	// Finalizes the statements that are not in use; the counters are kept.
+	void clear() { lru_.clear(); index_.clear(); }
+
+	// The first statement of sql, with tail set to the rest of it.
+	std::shared_ptr<sqlite3_stmt> prepare(std::shared_ptr<sqlite3> const& db, char const* sql, char const*& tail);
+
+private:
+	struct entry
+	{
+		std::string sql;
+		std::shared_ptr<sqlite3_stmt> stmt;
+		size_t tail; // offset in sql
+	};
+
+	std::list<entry> lru_; // most recently used first
+	std::unordered_map<std::string, std::list<entry>::iterator> index_;
+	size_t capacity_;
+	size_t hits_;
+	size_t misses_;
+
+	void trim();
+};
+
+
 class database
 {
 	friend class ext::function;
@@ -122,6 +173,7 @@ public:
 	}
 
 	void connect_v2(char const* const& dbname, int const& flags, char const* const& vfs = nullptr) {
+		cache_->clear();
 		db_.reset();
 
 		sqlite3* db(nullptr);
@@ -131,7 +183,7 @@ public:
 		db_.reset(db, deleter);
 	}
 
-	void disconnect() { db_.reset(); }
+	void disconnect() { cache_->clear(); db_.reset(); }
 	void attach(char const* dbname, char const* name) { executef("ATTACH '%s' AS '%s'", dbname, name); }
 	void detach(char const* name) { executef("DETACH '%s'", name); }
 
@@ -164,8 +216,14 @@ public:
 	void set_authorize_handler(authorize_handler const& h);
 	std::shared_ptr<sqlite3> const& get_ptr() const { return db_; }
 
+	// Statements of query and command are prepared through the cache, which
+	// keeps up to capacity of them (none by default).
+	void set_statement_cache_size(size_t const& capacity) { cache_->set_capacity(capacity); }
+	std::shared_ptr<statement_cache> const& get_statement_cache() const { return cache_; }
+
 private:
 	std::shared_ptr<sqlite3> db_;
+	std::shared_ptr<statement_cache> cache_ = std::make_shared<statement_cache>();
 
 	inline void check_rc(int const& rc) const
 	{ if (rc != SQLITE_OK) throw sqlite3_error(db_); }
@@ -264,10 +322,11 @@ public:
 
 	bool step() { return stepfun(stmt_); }
 	void reset() { check_rc(sqlite3_reset(stmt_.get())); }
+	std::shared_ptr<sqlite3_stmt> const& get_ptr() const { return stmt_; }
 
 protected:
 	explicit statement(const database& db, char const* const& sql = nullptr)
-		: db_(db.get_ptr()), tail_(nullptr) { if (sql && sql[0]) prepare(sql); }
+		: db_(db.get_ptr()), cache_(db.get_statement_cache()), tail_(nullptr) { if (sql && sql[0]) prepare(sql); }
 
 	~statement() {}
 
@@ -284,6 +343,10 @@ protected:
 	}
 	
 	void prepare_impl(char const* const& sql) {
+		if (cache_ && cache_->capacity()) {
+			stmt_ = cache_->prepare(db_, sql, tail_);
+			return;
+		}
 		sqlite3_stmt* stmt(nullptr);
 		check_rc(sqlite3_prepare(db_.get(), sql, sql? strlen(sql) : 0, &stmt, &tail_));
 		stmt_.reset(stmt, sqlite3_finalize);
@@ -291,6 +354,7 @@ protected:
 
 	std::shared_ptr<sqlite3_stmt> stmt_;
 	std::shared_ptr<sqlite3> db_;
+	std::shared_ptr<statement_cache> cache_;
 	char const* tail_;
 };
 
@@ -341,19 +405,59 @@ public:
 }; // class command
 
 
+// Non-owning view of the bytes of a BLOB column, like text_view for TEXT
+// ones. Views read from a row are only valid until the next step, reset or
+// finalization of the statement, or another read of the column as another
+// type.
+class blob_view
+{
+private:
+	uint8_t const* data_;
+	size_t size_;
+
+public:
+	typedef uint8_t value_type;
+	typedef uint8_t const* iterator;
+	typedef uint8_t const* const_iterator;
+
+	blob_view() : data_(nullptr), size_(0) {}
+	blob_view(void const* data, size_t const& size) : data_(static_cast<uint8_t const*>(data)), size_(size) {}
+
+	uint8_t const* data() const { return data_; }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	iterator begin() const { return data_; }
+	iterator end() const { return data_ + size_; }
+
+	uint8_t const& operator[](size_t const& i) const { return data_[i]; }
+
+	friend bool operator==(blob_view const& a, blob_view const& b) {
+		return a.size_ == b.size_ && (a.size_ == 0 || std::memcmp(a.data_, b.data_, a.size_) == 0);
+	}
+
+	friend bool operator!=(blob_view const& a, blob_view const& b) { return !(a == b); }
+};
+
+
+// Columns are read as numbers, as copies (std::string, std::u16string and
+// std::vector<uint8_t>, which keep their storage from one read to the next
+// when read through get(idx, value)), or as views into the row (char const*,
+// char16_t const*, text_view and blob_view), which are only valid until the
+// next step.
 class getter_base
 {
 private:
+	// Copies the value in one go, into the storage d already has if it is
+	// large enough. getfun is called before lenfun, which then counts the
+	// bytes of the converted value.
 	template<typename Cont, typename GetFun, typename LenFun>
 	static void get_generic(sqlite3_stmt* const& stmt, int const& idx, Cont& d, GetFun&& getfun, LenFun&& lenfun) {
 		typedef typename Cont::value_type val_t;
-		d.clear();
 		const val_t* s = reinterpret_cast<const val_t*>(getfun(stmt, idx));
 		int len = lenfun(stmt, idx) / sizeof(val_t);
-		if (len > 0) {
-			d.reserve(len);
-			std::copy(s, s + len, std::back_inserter(d));
-		}
+		if (s && len > 0) d.assign(s, s + len);
+		else d.clear();
 	}
 
 protected:
@@ -382,6 +486,16 @@ protected:
 	static void get(sqlite3_stmt* const& stmt, int const& idx, std::vector<uint8_t>& d) {
 		get_generic(stmt, idx, d, ::sqlite3_column_blob, ::sqlite3_column_bytes);
 	}
+
+	static void get(sqlite3_stmt* const& stmt, int const& idx, text_view& d) {
+		char const* s = reinterpret_cast<char const*>(::sqlite3_column_text(stmt, idx));
+		d = s? text_view(s, size_t(::sqlite3_column_bytes(stmt, idx))) : text_view::null();
+	}
+
+	static void get(sqlite3_stmt* const& stmt, int const& idx, blob_view& d) {
+		void const* s = ::sqlite3_column_blob(stmt, idx);
+		d = s? blob_view(s, size_t(::sqlite3_column_bytes(stmt, idx))) : blob_view();
+	}
 };
 
 template<size_t CurIndex, typename... Args>
@@ -465,7 +579,7 @@ public:
 	template <typename T> T get(int const& idx) const {
 		T value;
 		getter_base::get(stmt_.get(), idx, value);
-		return std::move(value);
+		return value;
 	}
 
 	template <typename T> void get(int const& idx, T& value) const {
@@ -495,14 +609,14 @@ public:
 	std::tuple<Ts...> get_columns(std::array<int,sizeof...(Ts)> const& indexes) const {
 		std::tuple<Ts...> ret;
 		get_columns(indexes, ret);
-		return std::move(ret);
+		return ret;
 	}
 
 	template<typename... Ts>
 	std::tuple<Ts...> get_columns(std::initializer_list<int> const& indexes) const {
 		std::tuple<Ts...> ret;
 		get_columns(indexes, ret);
-		return std::move(ret);
+		return ret;
 	}
 
 	getstream getter(int const& idx = 0) const { return getstream(stmt_, idx); }
@@ -572,6 +686,101 @@ private:
 	bool fcommit_;
 };
 
+
+// Connections to one database file for threads that use it at the same time,
+// each one by a single thread at a time: they are opened without SQLite's
+// own mutexes (SQLITE_OPEN_NOMUTEX), and handed out by leases that give them
+// back when they are destroyed. The file is put in WAL mode, so that readers
+// do not wait for each other or for the writer. Statements of a connection
+// (see statement_cache) must be done with when its lease ends.
+class database_pool
+{
+public:
+	struct options
+	{
+		size_t size;                 // connections; 0 for one per core
+		bool readonly;
+		int busy_timeout;            // ms
+		size_t statement_cache_size; // of each connection
+		std::function<void (database&)> setup; // of each connection, after the above
+
+		options() : size(0), readonly(false), busy_timeout(5000), statement_cache_size(64) {}
+	};
+
+	// Wait-time metrics of acquire().
+	struct stats
+	{
+		size_t leases;
+		size_t waits; // leases that waited for a connection
+		std::chrono::nanoseconds wait_time;
+		std::chrono::nanoseconds max_wait_time;
+	};
+
+	class lease
+	{
+	public:
+		lease() : pool_(nullptr), db_(nullptr) {}
+		lease(lease const&) = delete;
+		lease & operator=(lease const&) = delete;
+		lease(lease&& o) : pool_(o.pool_), db_(o.db_) { o.db_ = nullptr; }
+
+		lease & operator=(lease&& o) {
+			if (this != &o) {
+				release();
+				pool_ = o.pool_;
+				db_ = o.db_;
+				o.db_ = nullptr;
+			}
+			return *this;
+		}
+
+		~lease() { release(); }
+
+		explicit operator bool() const { return db_ != nullptr; }
+		database& operator*() const { return *db_; }
+		database* operator->() const { return db_; }
+
+		// Gives the connection back to the pool.
+		void release() {
+			if (db_) pool_->give_back(db_);
+			db_ = nullptr;
+		}
+
+	private:
+		lease(database_pool* pool, database* db) : pool_(pool), db_(db) {}
+
+		database_pool* pool_;
+		database* db_;
+
+		friend class database_pool;
+	};
+
+	database_pool(database_pool const&) = delete;
+	database_pool & operator=(database_pool const&) = delete;
+
+	// Opens the connections; throws sqlite3_error if one cannot be opened.
+	explicit database_pool(char const* dbname, options const& opts = options());
+
+	size_t size() const { return all_.size(); }
+
+	// A connection, as soon as one is free.
+	lease acquire();
+
+	// A connection if one is free, or else an empty lease.
+	lease try_acquire();
+
+	stats get_stats() const;
+
+private:
+	std::vector<std::unique_ptr<database>> all_;
+	std::vector<database*> free_;
+	mutable std::mutex mutex_;
+	std::condition_variable available_;
+	stats stats_;
+
+	void give_back(database* db);
+};
+
 } // namespace sqlite3pp
 
 } // namespace internal
@@ -0,0 +1,385 @@
+#ifndef QOLOR_SQLITE3_QUERY_DRIVER_H__
+#define QOLOR_SQLITE3_QUERY_DRIVER_H__
+
+#include "basic_iterable.h"
+#include "sqlite3_driver.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace sqlite3pp
+{
+
+// Reads columns 0 to N - 1 of the current row of a statement into the
+// elements of a tuple with the same indexes.
+template <size_t N>
+struct tuple_getter : private getter_base
+{
+	template <typename Tuple>
+	static void get(sqlite3_stmt* const& stmt, Tuple& dest) {
+		tuple_getter<N - 1>::get(stmt, dest);
+		getter_base::get(stmt, int(N - 1), std::get<N - 1>(dest));
+	}
+};
+
+template <>
+struct tuple_getter<0>
+{
+	template <typename Tuple>
+	static void get(sqlite3_stmt* const&, Tuple&) {}
+};
+
+// Steps a statement and reads its rows into tuples of Ts, column i into
+// element i. Copies share the statement, so only one of them can be
+// advanced, as with any input iterator.
+template <typename... Ts>
+class tuple_cursor
+{
+public:
+	typedef std::tuple<typename std::decay<Ts>::type...> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef value_type const& reference;
+	typedef value_type const* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+private:
+	std::shared_ptr<sqlite3_stmt> stmt_; // none at the end
+	value_type row_;
+
+	void step() {
+		switch (sqlite3_step(stmt_.get())) {
+		case SQLITE_ROW:
+			tuple_getter<sizeof...(Ts)>::get(stmt_.get(), row_);
+			break;
+		case SQLITE_OK:
+		case SQLITE_DONE:
+			stmt_.reset();
+			break;
+		default:
+			throw sqlite3_error(stmt_);
+		}
+	}
+
+public:
+	// End iterator.
+	tuple_cursor() {}
+
+	// The first row of a statement.
+	explicit tuple_cursor(std::shared_ptr<sqlite3_stmt> const& stmt) : stmt_(stmt) { if (stmt_) step(); }
+
+	tuple_cursor& operator++() {
+		step();
+		return *this;
+	}
+
+	tuple_cursor operator++(int) {
+		tuple_cursor i(*this);
+		step();
+		return i;
+	}
+
+	reference operator*() const { return row_; }
+	pointer operator->() const { return &row_; }
+
+	bool operator==(tuple_cursor const& o) const { return stmt_ == o.stmt_; }
+	bool operator!=(tuple_cursor const& o) const { return stmt_ != o.stmt_; }
+};
+
+// Text kept for a char const* or a text_view, which may be NULL (a null
+// pointer, or text_view::null()).
+struct insert_text
+{
+	bool null;
+	std::string text;
+};
+
+// How an element of type T of the rows that insert_sink inserts is kept
+// until it is bound: strings and blobs are copied into storage of the sink,
+// reused from one batch to the next, which is then bound without SQLite
+// copying it again.
+template <typename T>
+struct insert_value
+{
+	typedef T type;
+};
+
+template <> struct insert_value<text_view> { typedef insert_text type; };
+template <> struct insert_value<char const*> { typedef insert_text type; };
+template <> struct insert_value<blob_view> { typedef std::vector<uint8_t> type; };
+
+// The row kept for a Value: its elements if it is a tuple or a pair, or else
+// the value itself.
+template <typename Value>
+struct insert_row
+{
+	typedef std::tuple<typename insert_value<Value>::type> type;
+	typedef std::false_type is_tuple;
+};
+
+template <typename... Ts>
+struct insert_row<std::tuple<Ts...>>
+{
+	typedef std::tuple<typename insert_value<typename std::decay<Ts>::type>::type...> type;
+	typedef std::true_type is_tuple;
+};
+
+template <typename A, typename B>
+struct insert_row<std::pair<A, B>>
+{
+	typedef std::tuple<typename insert_value<typename std::decay<A>::type>::type,
+		typename insert_value<typename std::decay<B>::type>::type> type;
+	typedef std::true_type is_tuple;
+};
+
+class insert_binder_base : protected binder_base
+{
+protected:
+	template <typename T, typename U>
+	static void assign(T& d, U const& v) { d = v; }
+
+	static void assign(insert_text& d, text_view const& v) {
+		d.null = v.is_null();
+		d.text.assign(v.data(), v.size());
+	}
+
+	static void assign(insert_text& d, char const* const& v) {
+		d.null = !v;
+		if (v) d.text.assign(v); else d.text.clear();
+	}
+	static void assign(std::vector<uint8_t>& d, blob_view const& v) { d.assign(v.begin(), v.end()); }
+
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value, int>::type
+	bind_value(sqlite3_stmt* const& s, int const& i, T const& v) {
+		return (sizeof(T) < sizeof(int32_t) || (sizeof(T) == sizeof(int32_t) && std::is_signed<T>::value))?
+			binder_base::bind(s, i, int32_t(v)) : binder_base::bind(s, i, int64_t(v));
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_floating_point<T>::value, int>::type
+	bind_value(sqlite3_stmt* const& s, int const& i, T const& v) { return binder_base::bind(s, i, double(v)); }
+
+	static int bind_value(sqlite3_stmt* const& s, int const& i, null_type const&) { return binder_base::bind(s, i); }
+
+	static int bind_value(sqlite3_stmt* const& s, int const& i, std::string const& v) {
+		return sqlite3_bind_text(s, i, v.data(), int(v.size()), SQLITE_STATIC);
+	}
+
+	static int bind_value(sqlite3_stmt* const& s, int const& i, insert_text const& v) {
+		return v.null? binder_base::bind(s, i) : bind_value(s, i, v.text);
+	}
+
+	static int bind_value(sqlite3_stmt* const& s, int const& i, std::vector<uint8_t> const& v) {
+		return v.empty()? sqlite3_bind_zeroblob(s, i, 0) : binder_base::bind(s, i, v.data(), int(v.size()), true);
+	}
+};
+
+// Keeps the elements of values in rows, and binds rows to the parameters of
+// statements from first on, element N - 1 to parameter first + N - 1.
+template <size_t N>
+struct insert_binder : private insert_binder_base
+{
+	template <typename Row, typename Value>
+	static void store(Row& row, Value const& v) {
+		insert_binder<N - 1>::store(row, v);
+		insert_binder_base::assign(std::get<N - 1>(row), std::get<N - 1>(v));
+	}
+
+	template <typename Row>
+	static int bind(sqlite3_stmt* const& stmt, int const& first, Row const& row) {
+		int const rc = insert_binder<N - 1>::bind(stmt, first, row);
+		return (rc != SQLITE_OK)? rc : insert_binder_base::bind_value(stmt, first + int(N - 1), std::get<N - 1>(row));
+	}
+};
+
+template <>
+struct insert_binder<0>
+{
+	template <typename Row, typename Value>
+	static void store(Row&, Value const&) {}
+
+	template <typename Row>
+	static int bind(sqlite3_stmt* const&, int const&, Row const&) { return SQLITE_OK; }
+};
+
+// Inserts rows into a table with a multi-row INSERT, prepared once and run
+// for every rows_per_insert rows (the rest of them are inserted one at a
+// time by finish()), and commits every batch_rows rows (0 for all of them at
+// once). rows_per_insert divides batch_rows, so a batch size with no large
+// divisor (e.g. a prime) makes for narrow inserts. The table and the columns
+// are names, not SQL: they are quoted. Inserts that are made in a transaction
+// of the caller are left to it to commit. Until then, a failure rolls back
+// the rows of the current batch only.
+template <typename Value>
+class insert_sink
+{
+private:
+	typedef insert_row<typename std::decay<Value>::type> row_traits;
+	typedef typename row_traits::type row_type;
+	typedef insert_binder<std::tuple_size<row_type>::value> binder;
+
+	static constexpr size_t num_columns = std::tuple_size<row_type>::value;
+	static constexpr size_t max_rows_per_insert = 256;
+
+	database* db_;
+	std::string sql_; // up to VALUES
+	std::vector<row_type> pending_; // rows_per_insert of them
+	command insert_;
+	std::unique_ptr<command> single_;
+	size_t num_pending_;
+	size_t batch_rows_;
+	size_t uncommitted_;
+	size_t rows_;
+	std::unique_ptr<transaction> xct_;
+
+	// name quoted as an SQL identifier, so that it can be a keyword or have
+	// any characters.
+	static std::string identifier(std::string const& name) {
+		std::string ret = "\"";
+		for (char const c : name) {
+			if (c == '"') ret += '"';
+			ret += c;
+		}
+		return ret + "\"";
+	}
+
+	static std::string make_sql(std::string const& table, std::vector<std::string> const& columns) {
+		if (!columns.empty() && columns.size() != num_columns)
+			throw sqlite3_error("qolor: " + std::to_string(num_columns) + " values inserted into "
+				+ std::to_string(columns.size()) + " columns of " + table);
+		std::string ret = "INSERT INTO " + identifier(table);
+		for (size_t i = 0; i < columns.size(); ++i) ret += (i? ", " : " (") + identifier(columns[i]);
+		if (!columns.empty()) ret += ")";
+		return ret + " VALUES ";
+	}
+
+	static std::string values(size_t const& rows) {
+		std::string row = "(";
+		for (size_t i = 0; i < num_columns; ++i) row += i? ", ?" : "?";
+		row += ")";
+		std::string ret = row;
+		for (size_t i = 1; i < rows; ++i) ret += ", " + row;
+		return ret;
+	}
+
+	size_t rows_per_insert(size_t const& batch_rows) const {
+		size_t const params = size_t(sqlite3_limit(db_->get_ptr().get(), SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+		size_t n = std::min(std::max(params / num_columns, size_t(1)), size_t(max_rows_per_insert));
+		if (!batch_rows) return n;
+		// Whole inserts make a batch, so that commits fall every batch_rows rows.
+		n = std::min(n, batch_rows);
+		while (batch_rows % n) --n;
+		return n;
+	}
+
+	template <typename T>
+	void store(row_type& row, T const& v, std::true_type) { binder::store(row, v); }
+
+	template <typename T>
+	void store(row_type& row, T const& v, std::false_type) { binder::store(row, std::forward_as_tuple(v)); }
+
+	void run(command& cmd, size_t const& first, size_t const& count) {
+		sqlite3_stmt* const stmt = cmd.get_ptr().get();
+		for (size_t i = 0; i < count; ++i)
+			if (binder::bind(stmt, int(i * num_columns + 1), pending_[first + i]) != SQLITE_OK)
+				throw sqlite3_error(db_->get_ptr());
+		cmd.execute();
+		cmd.reset();
+	}
+
+	void flush() {
+		if (!num_pending_) return;
+		if (!xct_ && sqlite3_get_autocommit(db_->get_ptr().get()))
+			xct_.reset(new transaction(*db_));
+
+		if (num_pending_ == pending_.size()) run(insert_, 0, num_pending_);
+		else {
+			if (!single_) single_.reset(new command(*db_, (sql_ + values(1)).c_str()));
+			for (size_t i = 0; i < num_pending_; ++i) run(*single_, i, 1);
+		}
+		rows_ += num_pending_;
+		uncommitted_ += num_pending_;
+		num_pending_ = 0;
+
+		if (xct_ && batch_rows_ && uncommitted_ == batch_rows_) commit();
+	}
+
+	void commit() {
+		xct_->commit();
+		xct_.reset();
+		uncommitted_ = 0;
+	}
+
+public:
+	insert_sink(database& db, std::string const& table, std::vector<std::string> const& columns, size_t const& batch_rows)
+		: db_(&db), sql_(make_sql(table, columns)), pending_(rows_per_insert(batch_rows)),
+		insert_(db, (sql_ + values(pending_.size())).c_str()),
+		num_pending_(0), batch_rows_(batch_rows), uncommitted_(0), rows_(0) {}
+
+	template <typename T>
+	bool operator()(T const& v) {
+		store(pending_[num_pending_], v, typename insert_row<typename std::decay<T>::type>::is_tuple());
+		if (++num_pending_ == pending_.size()) flush();
+		return true;
+	}
+
+	// Inserts the rows that are left, and commits them.
+	void finish() {
+		flush();
+		if (xct_) commit();
+	}
+
+	size_t rows() const { return rows_; }
+};
+
+// The sink of iterable::insert_into(), found by argument-dependent lookup so
+// that iterables do not depend on SQLite.
+template <typename Value>
+insert_sink<Value> make_insert_sink(database& db, std::string const& table,
+	std::vector<std::string> const& columns, size_t const& batch_rows, Value const*)
+{
+	return insert_sink<Value>(db, table, columns, batch_rows);
+}
+
+} // namespace sqlite3pp
+
+} // namespace internal
+
+
+// The rows of a query as tuples of T, Ts: column 0 is read as T, column 1
+// as the first of Ts and so on, without looking the columns up by index on
+// every row (std::ignore skips a column). The query is reset first, keeping
+// its bindings, so that it runs from its first row; it must not be stepped
+// by anything else during the scan. char const*, text_view and blob_view
+// columns point into the row, and are only valid until the next one. Throws
+// sqlite3pp::sqlite3_error if the query has fewer columns than types, or if
+// a step fails.
+template <typename T, typename... Ts>
+internal::iterable<internal::sqlite3pp::tuple_cursor<T, Ts...>>
+from(internal::sqlite3pp::query& qry)
+{
+	typedef internal::sqlite3pp::tuple_cursor<T, Ts...> iter_t;
+
+	if (qry.column_count() < int(1 + sizeof...(Ts)))
+		throw internal::sqlite3pp::sqlite3_error("qolor: " + std::to_string(qry.column_count())
+			+ " columns read as " + std::to_string(1 + sizeof...(Ts)) + " types");
+	qry.reset();
+	return internal::iterable<iter_t>(iter_t(qry.get_ptr()), iter_t());
+}
+
+} // namespace qolor
+
+#endif // QOLOR_SQLITE3_QUERY_DRIVER_H__
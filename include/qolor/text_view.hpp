@@ -0,0 +1,111 @@
+#ifndef QOLOR_TEXT_VIEW_HPP__
+#define QOLOR_TEXT_VIEW_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace qolor
+{
+
+// Non-owning view of a run of characters, like std::string_view. It is only
+// valid while the text it points to is.
+class text_view
+{
+private:
+	char const* data_;
+	size_t size_;
+
+	static char const* null_data() { static char const none[1] = ""; return none; }
+
+public:
+	typedef char value_type;
+	typedef char const* iterator;
+	typedef char const* const_iterator;
+	typedef size_t size_type;
+
+	static constexpr size_t npos = size_t(-1);
+
+	text_view() : data_(""), size_(0) {}
+	text_view(char const* data, size_t const& size) : data_(data), size_(size) {}
+	text_view(char const* s) : data_(s), size_(std::strlen(s)) {}
+	text_view(std::string const& s) : data_(s.data()), size_(s.size()) {}
+
+	// The view of a NULL (e.g. of a NULL column): it is empty, and equal to
+	// any other empty view, but is_null() tells it apart from them.
+	static text_view null() { return text_view(null_data(), 0); }
+	bool is_null() const { return data_ == null_data(); }
+
+	char const* data() const { return data_; }
+	size_t size() const { return size_; }
+	size_t length() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	iterator begin() const { return data_; }
+	iterator end() const { return data_ + size_; }
+
+	char const& operator[](size_t const& i) const { return data_[i]; }
+	char const& front() const { return data_[0]; }
+	char const& back() const { return data_[size_ - 1]; }
+
+	text_view substr(size_t const& pos, size_t const& n = npos) const {
+		size_t const p = std::min(pos, size_);
+		return text_view(data_ + p, std::min(n, size_ - p));
+	}
+
+	size_t find(char const& c, size_t const& pos = 0) const {
+		if (pos >= size_) return npos;
+		void const* p = std::memchr(data_ + pos, c, size_ - pos);
+		return p? size_t(static_cast<char const*>(p) - data_) : npos;
+	}
+
+	bool starts_with(text_view const& o) const {
+		return o.size_ <= size_ && std::memcmp(data_, o.data_, o.size_) == 0;
+	}
+
+	std::string str() const { return std::string(data_, size_); }
+	explicit operator std::string() const { return str(); }
+
+	int compare(text_view const& o) const {
+		int const c = std::memcmp(data_, o.data_, std::min(size_, o.size_));
+		if (c) return c;
+		return (size_ < o.size_)? -1 : (size_ > o.size_)? 1 : 0;
+	}
+
+	friend bool operator==(text_view const& a, text_view const& b) {
+		return a.size_ == b.size_ && std::memcmp(a.data_, b.data_, a.size_) == 0;
+	}
+
+	friend bool operator!=(text_view const& a, text_view const& b) { return !(a == b); }
+	friend bool operator< (text_view const& a, text_view const& b) { return a.compare(b) <  0; }
+	friend bool operator> (text_view const& a, text_view const& b) { return a.compare(b) >  0; }
+	friend bool operator<=(text_view const& a, text_view const& b) { return a.compare(b) <= 0; }
+	friend bool operator>=(text_view const& a, text_view const& b) { return a.compare(b) >= 0; }
+
+	friend std::ostream& operator<<(std::ostream& os, text_view const& v) {
+		return os.write(v.data_, v.size_);
+	}
+};
+
+} // namespace qolor
+
+namespace std
+{
+
+template <>
+struct hash<qolor::text_view>
+{
+	size_t operator()(qolor::text_view const& v) const {
+		// FNV-1a
+		size_t h = size_t(14695981039346656037ULL);
+		for (char c : v) { h ^= size_t(static_cast<unsigned char>(c)); h *= size_t(1099511628211ULL); }
+		return h;
+	}
+};
+
+} // namespace std
+
+#endif // QOLOR_TEXT_VIEW_HPP__
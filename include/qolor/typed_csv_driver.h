@@ -0,0 +1,168 @@
+#ifndef QOLOR_TYPED_CSV_DRIVER_H__
+#define QOLOR_TYPED_CSV_DRIVER_H__
+
+#include "mapped_csv_driver.h"
+#include "field_parsers.h"
+#include <istream>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace qolor
+{
+
+namespace internal
+{
+
+namespace csv
+{
+
+// Reads the lines of a stream as rows of text_view fields, which point into
+// a line buffer that is reused from one row to the next. Like
+// delimited_text_iterator, a row is a line, so quoted fields cannot hold
+// newlines.
+class stream_csv_iterator
+{
+public:
+	typedef std::ptrdiff_t difference_type;
+	typedef mapped_row value_type;
+	typedef mapped_row const& reference;
+	typedef mapped_row const* pointer;
+	typedef std::input_iterator_tag iterator_category;
+
+private:
+	std::istream* is_;
+	std::shared_ptr<std::istream> owned_; // is_, if the iterators own it
+	char sep_;
+	std::string line_;
+	row_parser parser_;
+	mapped_row row_;
+	bool at_end_; // no more lines; always set in end iterators
+
+public:
+	stream_csv_iterator() = delete;
+
+	// The row of a copy points into the line of the copy.
+	stream_csv_iterator(stream_csv_iterator const& o)
+		: is_(o.is_), owned_(o.owned_), sep_(o.sep_), line_(o.line_), parser_(o.parser_), row_(o.row_), at_end_(o.at_end_) {
+		row_.data_ = line_.data();
+	}
+
+	stream_csv_iterator& operator=(stream_csv_iterator const& o) {
+		is_ = o.is_;
+		owned_ = o.owned_;
+		sep_ = o.sep_;
+		line_ = o.line_;
+		parser_ = o.parser_;
+		row_ = o.row_;
+		row_.data_ = line_.data();
+		at_end_ = o.at_end_;
+		return *this;
+	}
+
+	stream_csv_iterator(std::istream& is, char const& sep)
+		: is_(&is), sep_(sep), parser_("", 0, sep), at_end_(false) {}
+
+	// Reads a stream that lives as long as the iterators copied from this one.
+	stream_csv_iterator(std::shared_ptr<std::istream> const& is, char const& sep)
+		: is_(is.get()), owned_(is), sep_(sep), parser_("", 0, sep), at_end_(false) {}
+
+	// End iterator.
+	stream_csv_iterator(std::istream& is, qolor::utils::generic_end_iterator const&)
+		: is_(&is), sep_(','), at_end_(true) {}
+
+	stream_csv_iterator& operator++() {
+		row_.clear();
+		for (;;) {
+			if (!std::getline(*is_, line_)) { at_end_ = true; break; }
+			parser_.reset(line_.data(), line_.size());
+			row_.data_ = line_.data();
+			if (parser_.next_row(row_.fields_, row_.scratch_)) break; // else an empty line
+		}
+		return *this;
+	}
+
+	void project(std::vector<size_t> const& indexes) { parser_.project(indexes); }
+	void filter(field_filter const& filter) { parser_.filter(filter); }
+
+	reference operator*() const { return row_; }
+	pointer operator->() const { return &row_; }
+
+	bool operator==(stream_csv_iterator const& o) const { return at_end_ == o.at_end_ && is_ == o.is_; }
+	bool operator!=(stream_csv_iterator const& o) const { return !(*this == o); }
+};
+
+} // namespace csv
+
+} // namespace internal
+
+
+// Reads delimited text into tuples of Ts. The fields are converted straight
+// from the line buffer (see field_parsers.h): numbers without locales or
+// intermediate strings. std::ignore skips a column, text_view fields are only
+// valid until the next row.
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::stream_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv(std::istream& is, char const& field_sep = ',')
+{
+	typedef internal::csv::stream_csv_iterator iter_t;
+	iter_t begin(is, field_sep);
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(is, utils::generic_end_iterator()))
+		.select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+// Reads the given columns only, in the order of cols; see columns.
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::stream_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv(std::istream& is, columns const& cols, char const& field_sep = ',')
+{
+	return from_csv<T, Ts...>(is, cols, field_filter(), field_sep);
+}
+
+// Reads the rows that meet filter only, which are skipped before any of their
+// fields is converted; see field_filter.
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::stream_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv(std::istream& is, columns const& cols, field_filter const& filter, char const& field_sep = ',')
+{
+	typedef internal::csv::stream_csv_iterator iter_t;
+	iter_t begin(is, field_sep);
+	if (cols.by_name()) ++begin; // the header
+	begin.project(cols.resolve(*begin));
+	begin.filter(filter);
+	++begin;
+	return internal::iterable<iter_t>(std::move(begin), iter_t(is, utils::generic_end_iterator()))
+		.select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::mapped_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv_file(std::string const& path, char const& field_sep = ',')
+{
+	return from_csv_file(path, field_sep).select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::mapped_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv_file(std::string const& path, columns const& cols, char const& field_sep = ',')
+{
+	return from_csv_file(path, cols, field_sep).select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+template <typename T, typename... Ts>
+internal::iterable<internal::select_iterator<internal::csv::mapped_csv_iterator,
+	internal::csv::tuple_decoder<std::tuple<T, Ts...>>>>
+from_csv_file(std::string const& path, columns const& cols, field_filter const& filter, char const& field_sep = ',')
+{
+	return from_csv_file(path, cols, filter, field_sep).select(internal::csv::tuple_decoder<std::tuple<T, Ts...>>());
+}
+
+} // namespace qolor
+
+#endif // QOLOR_TYPED_CSV_DRIVER_H__
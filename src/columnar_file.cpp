@@ -0,0 +1,182 @@
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include "qolor/columnar_file.h"
+
+namespace
+{
+
+char const magic[8] = { 'Q', 'O', 'L', 'O', 'R', 'C', 'O', 'L' };
+uint32_t const version = 1;
+
+struct file_header
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t num_columns;
+	uint64_t num_rows;
+	uint64_t rows_per_block;
+	uint64_t num_blocks;
+	uint64_t directory;
+};
+
+size_t padded(size_t const& n) { return (n + 7) & ~size_t(7); }
+
+[[noreturn]] void invalid(std::string const& what)
+{
+	throw std::runtime_error("qolor: invalid columnar file: " + what);
+}
+
+} // namespace
+
+size_t qolor::internal::columnar::value_size(type_code const& type)
+{
+	switch (type) {
+	case type_code::int8: case type_code::uint8: case type_code::boolean: return 1;
+	case type_code::int16: case type_code::uint16: return 2;
+	case type_code::int32: case type_code::uint32: case type_code::float32: return 4;
+	case type_code::int64: case type_code::uint64: case type_code::float64: return 8;
+	case type_code::string: return 0;
+	}
+	return 0;
+}
+
+void qolor::internal::columnar::column_buffer::clear()
+{
+	data.clear();
+	offsets.assign(1, 0);
+	min = std::numeric_limits<double>::infinity();
+	max = -std::numeric_limits<double>::infinity();
+}
+
+qolor::internal::columnar::file_writer::file_writer(std::string const& path, std::vector<type_code> const& types,
+	std::vector<std::string> const& names, size_t const& rows_per_block)
+	: os_(path, std::ios::binary | std::ios::trunc), path_(path), types_(types), names_(names),
+	rows_per_block_(rows_per_block? rows_per_block : 1), num_rows_(0)
+{
+	if (!os_) throw std::system_error(errno, std::system_category(), "cannot create " + path);
+	names_.resize(types_.size());
+	file_header h = file_header();
+	write(&h, sizeof(h));
+}
+
+void qolor::internal::columnar::file_writer::write(void const* data, size_t const& size)
+{
+	os_.write(static_cast<char const*>(data), std::streamsize(size));
+	if (!os_) throw std::system_error(errno? errno : EIO, std::system_category(), "cannot write " + path_);
+}
+
+void qolor::internal::columnar::file_writer::pad()
+{
+	static char const zeros[8] = {};
+	size_t const pos = size_t(os_.tellp());
+	write(zeros, padded(pos) - pos);
+}
+
+void qolor::internal::columnar::file_writer::write_block(size_t const& rows, std::vector<column_buffer>& columns)
+{
+	for (auto& c : columns) {
+		block_entry e = { uint64_t(os_.tellp()), 0, c.min, c.max };
+		if (c.type == type_code::string) {
+			write(c.offsets.data(), c.offsets.size() * sizeof(uint64_t));
+			e.size = c.offsets.size() * sizeof(uint64_t);
+		}
+		write(c.data.data(), c.data.size());
+		e.size += c.data.size();
+		pad();
+		blocks_.push_back(e);
+		c.clear();
+	}
+	num_rows_ += rows;
+}
+
+void qolor::internal::columnar::file_writer::finish()
+{
+	file_header h;
+	std::memcpy(h.magic, magic, sizeof(magic));
+	h.version = version;
+	h.num_columns = uint32_t(types_.size());
+	h.num_rows = num_rows_;
+	h.rows_per_block = rows_per_block_;
+	h.num_blocks = types_.empty()? 0 : blocks_.size() / types_.size();
+	h.directory = uint64_t(os_.tellp());
+
+	write(types_.data(), types_.size() * sizeof(type_code));
+	pad();
+	for (auto const& name : names_) {
+		uint64_t const n = name.size();
+		write(&n, sizeof(n));
+		write(name.data(), name.size());
+	}
+	pad();
+	write(blocks_.data(), blocks_.size() * sizeof(block_entry));
+
+	os_.seekp(0);
+	write(&h, sizeof(h));
+	os_.close();
+	if (!os_) throw std::system_error(errno? errno : EIO, std::system_category(), "cannot write " + path_);
+}
+
+qolor::internal::columnar::file_reader::file_reader(std::string const& path)
+	: file_(std::make_shared<utils::mapped_file>(path))
+{
+	char const* data = file_->data();
+	size_t const size = file_->size();
+
+	file_header h;
+	if (size < sizeof(h)) invalid(path);
+	std::memcpy(&h, data, sizeof(h));
+	if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) invalid(path);
+	if (h.version != version) invalid(path + " (version " + std::to_string(h.version) + ")");
+	num_rows_ = h.num_rows;
+	rows_per_block_ = h.rows_per_block;
+	num_blocks_ = h.num_blocks;
+	if (!rows_per_block_ || num_blocks_ != (num_rows_ + rows_per_block_ - 1) / rows_per_block_) invalid(path);
+
+	size_t pos = size_t(h.directory);
+	if (pos > size || (size - pos) / sizeof(type_code) < h.num_columns) invalid(path);
+	types_.resize(h.num_columns);
+	std::memcpy(types_.data(), data + pos, types_.size() * sizeof(type_code));
+	pos = padded(pos + types_.size() * sizeof(type_code));
+	for (auto const& t : types_)
+		if (t < type_code::int8 || t > type_code::string) invalid(path);
+
+	for (size_t c = 0; c < types_.size(); ++c) {
+		uint64_t n;
+		if (pos > size || size - pos < sizeof(n)) invalid(path);
+		std::memcpy(&n, data + pos, sizeof(n));
+		pos += sizeof(n);
+		if (size - pos < n) invalid(path);
+		names_.push_back(std::string(data + pos, size_t(n)));
+		pos += size_t(n);
+	}
+	pos = padded(pos);
+
+	uint64_t const num_entries = num_blocks_ * types_.size();
+	if (pos > size || (size - pos) / sizeof(block_entry) < num_entries) invalid(path);
+	blocks_ = reinterpret_cast<block_entry const*>(data + pos);
+
+	// Blocks must fit in the file, with their offsets for strings.
+	for (size_t b = 0; b < num_blocks_; ++b) {
+		for (size_t c = 0; c < types_.size(); ++c) {
+			block_entry const& e = entry(b, c);
+			if (e.offset > size || size - e.offset < e.size || (e.offset & 7)) invalid(path);
+			size_t const rows = rows_in_block(b);
+			if (types_[c] == type_code::string && e.size < (rows + 1) * sizeof(uint64_t)) invalid(path);
+			if (e.size < rows * value_size(types_[c])) invalid(path);
+		}
+	}
+}
+
+void qolor::internal::columnar::file_reader::check_strings(size_t const& block, size_t const& column) const
+{
+	size_t const rows = rows_in_block(block);
+	uint64_t const* offsets = reinterpret_cast<uint64_t const*>(data(block, column));
+	uint64_t const chars = entry(block, column).size - (rows + 1) * sizeof(uint64_t);
+	for (size_t i = 0; i < rows; ++i)
+		if (offsets[i] > offsets[i + 1]) invalid("string offsets");
+	if (offsets[0] != 0 || offsets[rows] > chars) invalid("string offsets");
+}
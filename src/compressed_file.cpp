@@ -0,0 +1,149 @@
+#include <cerrno>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+#include "qolor/compressed_file.h"
+
+namespace
+{
+
+struct buffer
+{
+	std::unique_ptr<char[]> data;
+	size_t size;
+};
+
+} // namespace
+
+struct qolor::utils::decompressing_streambuf::state
+{
+	gzFile file;
+	size_t buffer_size;
+	size_t num_buffers;
+	std::thread thread;
+
+	std::mutex mutex;
+	std::condition_variable ready; // a buffer is filled, or the thread stopped
+	std::condition_variable space; // a buffer was returned, or the reader is gone
+	std::deque<buffer> filled;
+	std::vector<buffer> free;
+	size_t allocated;
+	std::exception_ptr error;
+	bool done;
+	bool cancelled;
+
+	buffer current; // read by the reader only
+
+	// Reads as much as fits in buf; less only at the end of the file.
+	size_t read(char* buf, size_t const& size) {
+		size_t n = 0;
+		while (n < size) {
+			int const r = gzread(file, buf + n, unsigned(size - n));
+			if (r <= 0) {
+				// A truncated file ends without an error from gzread.
+				int err;
+				char const* msg = gzerror(file, &err);
+				if (r < 0 || (err != Z_OK && err != Z_STREAM_END))
+					throw std::runtime_error(std::string("qolor: cannot decompress: ") + msg);
+				break;
+			}
+			n += size_t(r);
+		}
+		return n;
+	}
+
+	void work() {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			space.wait(lock, [this]() { return cancelled || !free.empty() || allocated < num_buffers; });
+			if (cancelled) break;
+
+			buffer b;
+			if (free.empty()) {
+				b.data.reset(new char[buffer_size]);
+				++allocated;
+			}
+			else { b = std::move(free.back()); free.pop_back(); }
+
+			lock.unlock();
+			try { b.size = read(b.data.get(), buffer_size); }
+			catch (...) {
+				lock.lock();
+				error = std::current_exception();
+				break;
+			}
+			lock.lock();
+			if (b.size == 0) break;
+			filled.push_back(std::move(b));
+			ready.notify_all();
+		}
+		done = true;
+		ready.notify_all();
+	}
+};
+
+qolor::utils::decompressing_streambuf::decompressing_streambuf(std::string const& path,
+	size_t buffer_size, size_t num_buffers)
+	: state_(new state())
+{
+	state_->file = gzopen(path.c_str(), "rb");
+	if (!state_->file) {
+		int const err = errno? errno : ENOMEM;
+		throw std::system_error(err, std::system_category(), "cannot open " + path);
+	}
+	gzbuffer(state_->file, 256 * 1024);
+	state_->buffer_size = std::max<size_t>(1, buffer_size);
+	state_->num_buffers = std::max<size_t>(1, num_buffers);
+	state_->allocated = 0;
+	state_->done = false;
+	state_->cancelled = false;
+	state_->current.size = 0;
+	state* s = state_.get();
+	state_->thread = std::thread([s]() { s->work(); });
+}
+
+qolor::utils::decompressing_streambuf::~decompressing_streambuf()
+{
+	{
+		std::lock_guard<std::mutex> g(state_->mutex);
+		state_->cancelled = true;
+	}
+	state_->space.notify_all();
+	state_->thread.join();
+	gzclose(state_->file);
+}
+
+qolor::utils::decompressing_streambuf::int_type qolor::utils::decompressing_streambuf::underflow()
+{
+	if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+	state& s = *state_;
+	std::unique_lock<std::mutex> lock(s.mutex);
+	if (s.current.data) {
+		s.free.push_back(std::move(s.current));
+		s.space.notify_all();
+	}
+	s.ready.wait(lock, [&s]() { return !s.filled.empty() || s.done; });
+	if (s.filled.empty()) {
+		setg(nullptr, nullptr, nullptr);
+		if (s.error) {
+			std::exception_ptr e = s.error;
+			s.error = nullptr;
+			std::rethrow_exception(e);
+		}
+		return traits_type::eof();
+	}
+	s.current = std::move(s.filled.front());
+	s.filled.pop_front();
+	char* p = s.current.data.get();
+	setg(p, p, p + s.current.size);
+	return traits_type::to_int_type(*p);
+}
@@ -0,0 +1,201 @@
+#include <cstring>
+#include "qolor/csv_scanner.h"
+#include "qolor/simd_kernels.h"
+
+// Same scheme as simd_kernels.cpp: one scanner per instruction set, through
+// target attributes, and the best one is picked at run time.
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define QOLOR_CSV_X86 1
+#define QOLOR_CSV_INLINE inline __attribute__((always_inline))
+#include <immintrin.h>
+#else
+#define QOLOR_CSV_INLINE inline
+#endif
+
+namespace
+{
+
+using qolor::simd::isa;
+
+// Masks of the quotes, separators and newlines of a block of 64 bytes.
+struct block_masks
+{
+	uint64_t quote;
+	uint64_t sep;
+	uint64_t newline;
+};
+
+struct scalar_classifier
+{
+	char sep_;
+
+	explicit scalar_classifier(char const& sep) : sep_(sep) {}
+
+	QOLOR_CSV_INLINE block_masks classify(char const* p) const {
+		block_masks m = { 0, 0, 0 };
+		for (unsigned i = 0; i < 64; ++i) {
+			m.quote |= uint64_t(p[i] == '"') << i;
+			m.sep |= uint64_t(p[i] == sep_) << i;
+			m.newline |= uint64_t(p[i] == '\n') << i;
+		}
+		return m;
+	}
+
+	// Bit i of the result is the XOR of bits 0 to i of x.
+	static QOLOR_CSV_INLINE uint64_t prefix_xor(uint64_t x) {
+		x ^= x << 1;
+		x ^= x << 2;
+		x ^= x << 4;
+		x ^= x << 8;
+		x ^= x << 16;
+		x ^= x << 32;
+		return x;
+	}
+};
+
+#ifdef QOLOR_CSV_X86
+
+struct sse2_classifier
+{
+	__m128i sep_, quote_, newline_;
+
+	__attribute__((target("sse2"))) explicit sse2_classifier(char const& sep)
+		: sep_(_mm_set1_epi8(sep)), quote_(_mm_set1_epi8('"')), newline_(_mm_set1_epi8('\n')) {}
+
+	static inline __attribute__((target("sse2")))
+	uint64_t mask(__m128i const& a, __m128i const& b, __m128i const& c, __m128i const& d, __m128i const& v) {
+		return uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(a, v))))
+			| (uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(b, v)))) << 16)
+			| (uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(c, v)))) << 32)
+			| (uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(d, v)))) << 48);
+	}
+
+	inline __attribute__((target("sse2"))) block_masks classify(char const* p) const {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + 16));
+		__m128i c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + 32));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + 48));
+		block_masks m = { mask(a, b, c, d, quote_), mask(a, b, c, d, sep_), mask(a, b, c, d, newline_) };
+		return m;
+	}
+
+	static QOLOR_CSV_INLINE uint64_t prefix_xor(uint64_t const& x) { return scalar_classifier::prefix_xor(x); }
+};
+
+// Every CPU with AVX2 also has carry-less multiplication, which computes the
+// prefix-XOR in one instruction: x times all ones.
+struct avx2_classifier
+{
+	__m256i sep_, quote_, newline_;
+
+	__attribute__((target("avx2"))) explicit avx2_classifier(char const& sep)
+		: sep_(_mm256_set1_epi8(sep)), quote_(_mm256_set1_epi8('"')), newline_(_mm256_set1_epi8('\n')) {}
+
+	static inline __attribute__((target("avx2")))
+	uint64_t mask(__m256i const& lo, __m256i const& hi, __m256i const& v) {
+		return uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v))))
+			| (uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v)))) << 32);
+	}
+
+	inline __attribute__((target("avx2"))) block_masks classify(char const* p) const {
+		__m256i lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+		__m256i hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + 32));
+		block_masks m = { mask(lo, hi, quote_), mask(lo, hi, sep_), mask(lo, hi, newline_) };
+		return m;
+	}
+
+	static inline __attribute__((target("avx2,pclmul"))) uint64_t prefix_xor(uint64_t const& x) {
+		__m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, int64_t(x)), _mm_set1_epi8(char(0xFF)), 0);
+		return uint64_t(_mm_cvtsi128_si64(r));
+	}
+};
+
+#endif // QOLOR_CSV_X86
+
+template <typename Classifier>
+QOLOR_CSV_INLINE uint64_t structurals(Classifier const& c, char const* p, uint64_t& in_quotes)
+{
+	block_masks m = c.classify(p);
+	// Quoted parts run from an opening quote up to (not including) its
+	// closing quote; the sign bit carries them over to the next block.
+	uint64_t const quoted = Classifier::prefix_xor(m.quote) ^ in_quotes;
+	in_quotes = uint64_t(int64_t(quoted) >> 63);
+	return (m.sep | m.newline) & ~quoted;
+}
+
+QOLOR_CSV_INLINE size_t flatten(uint64_t bits, uint32_t const& base, uint32_t* out, size_t k)
+{
+	while (bits) {
+		out[k++] = base + uint32_t(__builtin_ctzll(bits));
+		bits &= bits - 1;
+	}
+	return k;
+}
+
+template <typename Classifier>
+QOLOR_CSV_INLINE size_t scan_kernel(char const* p, size_t n, char sep, uint64_t& in_quotes, uint32_t* out)
+{
+	Classifier const c(sep);
+	size_t k = 0, i = 0;
+	for (; i + 64 <= n; i += 64)
+		k = flatten(structurals(c, p + i, in_quotes), uint32_t(i), out, k);
+
+	if (i < n) {
+		// The last partial block is padded with a character that cannot be
+		// structural.
+		char block[64];
+		std::memset(block, (sep == ' ')? 'x' : ' ', sizeof(block));
+		std::memcpy(block, p + i, n - i);
+		uint64_t const bits = structurals(c, block, in_quotes);
+		k = flatten(bits & ((uint64_t(1) << (n - i)) - 1), uint32_t(i), out, k);
+		// The padding has no quotes, so the state at its end is the state at
+		// the end of the data.
+	}
+	return k;
+}
+
+typedef size_t (*scan_func)(char const*, size_t, char, uint64_t&, uint32_t*);
+
+size_t scan_scalar(char const* p, size_t n, char sep, uint64_t& in_quotes, uint32_t* out)
+{
+	return scan_kernel<scalar_classifier>(p, n, sep, in_quotes, out);
+}
+
+#ifdef QOLOR_CSV_X86
+
+__attribute__((target("sse2")))
+size_t scan_sse2(char const* p, size_t n, char sep, uint64_t& in_quotes, uint32_t* out)
+{
+	return scan_kernel<sse2_classifier>(p, n, sep, in_quotes, out);
+}
+
+__attribute__((target("avx2,pclmul")))
+size_t scan_avx2(char const* p, size_t n, char sep, uint64_t& in_quotes, uint32_t* out)
+{
+	return scan_kernel<avx2_classifier>(p, n, sep, in_quotes, out);
+}
+
+#endif // QOLOR_CSV_X86
+
+scan_func select_scanner()
+{
+	switch (qolor::simd::active_isa()) {
+#ifdef QOLOR_CSV_X86
+	case isa::avx2:
+		if (__builtin_cpu_supports("pclmul")) return &scan_avx2;
+		return &scan_sse2;
+	case isa::sse2: return &scan_sse2;
+#endif
+	default: return &scan_scalar;
+	}
+}
+
+} // namespace
+
+
+size_t qolor::internal::csv::scan_structurals(char const* data, size_t size, char sep, uint64_t& in_quotes, uint32_t* out)
+{
+	static scan_func const scan = select_scanner();
+	return scan(data, size, sep, in_quotes, out);
+}
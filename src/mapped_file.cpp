@@ -0,0 +1,74 @@
+#include <cerrno>
+#include <system_error>
+#include "qolor/mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define QOLOR_HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+#ifdef QOLOR_HAS_MMAP
+
+qolor::utils::mapped_file::mapped_file(std::string const& path)
+	: data_(""), size_(0), mapped_(false)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::system_error(errno, std::system_category(), "cannot open " + path);
+
+	struct stat st;
+	if (::fstat(fd, &st) < 0) {
+		int err = errno;
+		::close(fd);
+		throw std::system_error(err, std::system_category(), "cannot stat " + path);
+	}
+
+	// Empty files cannot be mapped.
+	if (st.st_size > 0) {
+		void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			int err = errno;
+			::close(fd);
+			throw std::system_error(err, std::system_category(), "cannot map " + path);
+		}
+		::madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+		data_ = static_cast<char const*>(p);
+		size_ = size_t(st.st_size);
+		mapped_ = true;
+	}
+	::close(fd);
+}
+
+qolor::utils::mapped_file::~mapped_file()
+{
+	if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+#else
+
+qolor::utils::mapped_file::mapped_file(std::string const& path)
+	: data_(""), size_(0), mapped_(false)
+{
+	std::ifstream is(path, std::ios::binary);
+	if (!is)
+		throw std::system_error(errno, std::system_category(), "cannot open " + path);
+	std::vector<char> buf((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	char* p = new char[buf.size() + 1];
+	std::copy(buf.begin(), buf.end(), p);
+	data_ = p;
+	size_ = buf.size();
+}
+
+qolor::utils::mapped_file::~mapped_file()
+{
+	delete[] data_;
+}
+
+#endif
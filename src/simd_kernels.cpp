@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <limits>
+#include "qolor/simd_kernels.h"
+
+// The kernels are plain loops over blocks of independent lanes, which the
+// compiler turns into vector code. Each one is compiled once per instruction
+// set (through target attributes) and the best version is picked at run time.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define QOLOR_SIMD_X86 1
+#define QOLOR_SIMD_INLINE inline __attribute__((always_inline))
+#else
+#define QOLOR_SIMD_INLINE inline
+#endif
+
+namespace
+{
+
+using qolor::simd::isa;
+
+// Two 256-bit registers worth of lanes.
+template <typename T>
+struct lanes { static constexpr size_t value = 64 / sizeof(T); };
+
+// Integers are added as unsigned, so that overflow wraps around instead of
+// being undefined.
+template <typename T, bool IsInt = std::is_integral<T>::value>
+struct sum_type { typedef typename std::make_unsigned<T>::type type; };
+
+template <typename T>
+struct sum_type<T, false> { typedef T type; };
+
+// Lane counters, as wide as the values they count.
+template <size_t S> struct counter_type { typedef uint64_t type; };
+template <> struct counter_type<1> { typedef uint8_t type; };
+template <> struct counter_type<2> { typedef uint16_t type; };
+template <> struct counter_type<4> { typedef uint32_t type; };
+
+template <typename T>
+QOLOR_SIMD_INLINE T sum_kernel(T const* p, size_t n)
+{
+	typedef typename sum_type<T>::type U;
+	static constexpr size_t L = lanes<T>::value;
+	U acc[L] = {};
+	size_t i = 0;
+	for (; i + L <= n; i += L)
+		for (size_t j = 0; j < L; ++j) acc[j] += U(p[i + j]);
+	U s = U();
+	for (size_t j = 0; j < L; ++j) s += acc[j];
+	for (; i < n; ++i) s += U(p[i]);
+	return T(s);
+}
+
+template <typename T, typename Less>
+QOLOR_SIMD_INLINE T select_kernel(T const* p, size_t n, Less less)
+{
+	static constexpr size_t L = lanes<T>::value;
+	T m = p[0];
+	size_t i = 0;
+	if (n >= L) {
+		T acc[L];
+		for (size_t j = 0; j < L; ++j) acc[j] = p[j];
+		for (i = L; i + L <= n; i += L)
+			for (size_t j = 0; j < L; ++j) acc[j] = less(p[i + j], acc[j])? p[i + j] : acc[j];
+		m = acc[0];
+		for (size_t j = 1; j < L; ++j) if (less(acc[j], m)) m = acc[j];
+	}
+	for (; i < n; ++i) if (less(p[i], m)) m = p[i];
+	return m;
+}
+
+struct less_than { template <typename T> bool operator()(T const& a, T const& b) const { return a < b; } };
+struct greater_than { template <typename T> bool operator()(T const& a, T const& b) const { return b < a; } };
+
+template <typename T>
+QOLOR_SIMD_INLINE size_t count_kernel(T const* p, size_t n, T v)
+{
+	typedef typename counter_type<sizeof(T)>::type C;
+	static constexpr size_t L = lanes<T>::value;
+	// Lane counters are flushed before they can overflow.
+	static constexpr size_t max_blocks = std::numeric_limits<C>::max();
+	size_t total = 0, i = 0;
+	while (i + L <= n) {
+		C acc[L] = {};
+		size_t const blocks = std::min((n - i) / L, max_blocks);
+		for (size_t b = 0; b < blocks; ++b, i += L)
+			for (size_t j = 0; j < L; ++j) acc[j] += C(p[i + j] == v);
+		for (size_t j = 0; j < L; ++j) total += acc[j];
+	}
+	for (; i < n; ++i) total += (p[i] == v);
+	return total;
+}
+
+template <typename T>
+QOLOR_SIMD_INLINE size_t find_kernel(T const* p, size_t n, T v)
+{
+	typedef typename counter_type<sizeof(T)>::type C;
+	static constexpr size_t L = lanes<T>::value;
+	// Blocks are scanned without branches, then the block with the match is
+	// scanned again to locate it.
+	static constexpr size_t B = 4 * L;
+	size_t i = 0;
+	for (; i + B <= n; i += B) {
+		C hit[L] = {};
+		for (size_t k = 0; k < B; k += L)
+			for (size_t j = 0; j < L; ++j) hit[j] |= C(p[i + k + j] == v);
+		C any = 0;
+		for (size_t j = 0; j < L; ++j) any |= hit[j];
+		if (any) break;
+	}
+	for (; i < n; ++i) if (p[i] == v) return i;
+	return n;
+}
+
+template <typename T>
+struct kernel_set
+{
+	T (*sum)(T const*, size_t);
+	T (*min)(T const*, size_t);
+	T (*max)(T const*, size_t);
+	size_t (*count)(T const*, size_t, T);
+	size_t (*find)(T const*, size_t, T);
+};
+
+template <typename T>
+struct scalar_kernels
+{
+	static T sum(T const* p, size_t n) { return sum_kernel(p, n); }
+	static T min(T const* p, size_t n) { return select_kernel(p, n, less_than()); }
+	static T max(T const* p, size_t n) { return select_kernel(p, n, greater_than()); }
+	static size_t count(T const* p, size_t n, T v) { return count_kernel(p, n, v); }
+	static size_t find(T const* p, size_t n, T v) { return find_kernel(p, n, v); }
+};
+
+#ifdef QOLOR_SIMD_X86
+
+template <typename T>
+struct sse2_kernels
+{
+	__attribute__((target("sse2"))) static T sum(T const* p, size_t n) { return sum_kernel(p, n); }
+	__attribute__((target("sse2"))) static T min(T const* p, size_t n) { return select_kernel(p, n, less_than()); }
+	__attribute__((target("sse2"))) static T max(T const* p, size_t n) { return select_kernel(p, n, greater_than()); }
+	__attribute__((target("sse2"))) static size_t count(T const* p, size_t n, T v) { return count_kernel(p, n, v); }
+	__attribute__((target("sse2"))) static size_t find(T const* p, size_t n, T v) { return find_kernel(p, n, v); }
+};
+
+template <typename T>
+struct avx2_kernels
+{
+	__attribute__((target("avx2"))) static T sum(T const* p, size_t n) { return sum_kernel(p, n); }
+	__attribute__((target("avx2"))) static T min(T const* p, size_t n) { return select_kernel(p, n, less_than()); }
+	__attribute__((target("avx2"))) static T max(T const* p, size_t n) { return select_kernel(p, n, greater_than()); }
+	__attribute__((target("avx2"))) static size_t count(T const* p, size_t n, T v) { return count_kernel(p, n, v); }
+	__attribute__((target("avx2"))) static size_t find(T const* p, size_t n, T v) { return find_kernel(p, n, v); }
+};
+
+#endif // QOLOR_SIMD_X86
+
+template <template <typename> class K, typename T>
+kernel_set<T> make_kernel_set()
+{
+	kernel_set<T> k = { &K<T>::sum, &K<T>::min, &K<T>::max, &K<T>::count, &K<T>::find };
+	return k;
+}
+
+template <typename T>
+kernel_set<T> const& kernels()
+{
+	static kernel_set<T> const k = [] {
+		switch (qolor::simd::active_isa()) {
+#ifdef QOLOR_SIMD_X86
+		case isa::avx2: return make_kernel_set<avx2_kernels, T>();
+		case isa::sse2: return make_kernel_set<sse2_kernels, T>();
+#endif
+		default: return make_kernel_set<scalar_kernels, T>();
+		}
+	}();
+	return k;
+}
+
+isa detect_isa()
+{
+#ifdef QOLOR_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return isa::avx2;
+	if (__builtin_cpu_supports("sse2")) return isa::sse2;
+#endif
+	return isa::scalar;
+}
+
+} // namespace
+
+
+qolor::simd::isa qolor::simd::active_isa()
+{
+	static isa const i = detect_isa();
+	return i;
+}
+
+char const* qolor::simd::isa_name(isa const& i)
+{
+	switch (i) {
+	case isa::avx2: return "avx2";
+	case isa::sse2: return "sse2";
+	default: return "scalar";
+	}
+}
+
+namespace qolor
+{
+
+namespace simd
+{
+
+namespace detail
+{
+
+template <typename T> T sum(T const* p, size_t n) { return kernels<T>().sum(p, n); }
+template <typename T> T min(T const* p, size_t n) { return kernels<T>().min(p, n); }
+template <typename T> T max(T const* p, size_t n) { return kernels<T>().max(p, n); }
+template <typename T> size_t count(T const* p, size_t n, T v) { return kernels<T>().count(p, n, v); }
+template <typename T> size_t find(T const* p, size_t n, T v) { return kernels<T>().find(p, n, v); }
+
+#define QOLOR_SIMD_INSTANTIATE(T) \
+	template T sum<T>(T const*, size_t); \
+	template T min<T>(T const*, size_t); \
+	template T max<T>(T const*, size_t); \
+	template size_t count<T>(T const*, size_t, T); \
+	template size_t find<T>(T const*, size_t, T);
+
+QOLOR_SIMD_INSTANTIATE(char)
+QOLOR_SIMD_INSTANTIATE(int8_t)
+QOLOR_SIMD_INSTANTIATE(uint8_t)
+QOLOR_SIMD_INSTANTIATE(int16_t)
+QOLOR_SIMD_INSTANTIATE(uint16_t)
+QOLOR_SIMD_INSTANTIATE(int32_t)
+QOLOR_SIMD_INSTANTIATE(uint32_t)
+QOLOR_SIMD_INSTANTIATE(int64_t)
+QOLOR_SIMD_INSTANTIATE(uint64_t)
+QOLOR_SIMD_INSTANTIATE(float)
+QOLOR_SIMD_INSTANTIATE(double)
+
+#undef QOLOR_SIMD_INSTANTIATE
+
+} // namespace detail
+
+} // namespace simd
+
+} // namespace qolor
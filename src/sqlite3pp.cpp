@@ -23,7 +23,9 @@
 // THE SOFTWARE.
 
 #include "qolor/sqlite3_driver.h"
+#include <algorithm>
 #include <memory>
+#include <thread>
 
 using namespace qolor::internal::sqlite3pp;
 
@@ -32,6 +34,70 @@ sqlite3_error::sqlite3_error(database const& db)
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+
+// Resets a cached statement when the last of its users is done with it, so
+// that it does not keep a transaction or a read snapshot open while it is
+// in the cache.
+struct reset_on_release
+{
+	std::shared_ptr<sqlite3_stmt> stmt;
+	void operator()(sqlite3_stmt* s) const { sqlite3_reset(s); }
+};
+
+std::shared_ptr<sqlite3_stmt> hand_out(std::shared_ptr<sqlite3_stmt> const& stmt)
+{
+	return std::shared_ptr<sqlite3_stmt>(stmt.get(), reset_on_release{stmt});
+}
+
+} // namespace
+
+std::shared_ptr<sqlite3_stmt> statement_cache::prepare(std::shared_ptr<sqlite3> const& db, char const* sql, char const*& tail)
+{
+	std::string key(sql? sql : "");
+	auto found = index_.find(key);
+	if (found != index_.end() && found->second->stmt.use_count() == 1) {
+		++hits_;
+		lru_.splice(lru_.begin(), lru_, found->second);
+		entry const& e = lru_.front();
+		sqlite3_reset(e.stmt.get()); // returns the error of the last step, if any
+		sqlite3_clear_bindings(e.stmt.get());
+		tail = sql + e.tail;
+		return hand_out(e.stmt);
+	}
+
+	++misses_;
+	sqlite3_stmt* stmt(nullptr);
+	unsigned int const flags = capacity_? SQLITE_PREPARE_PERSISTENT : 0;
+	if (sqlite3_prepare_v3(db.get(), key.c_str(), int(key.size()), flags, &stmt, &tail) != SQLITE_OK)
+		throw sqlite3_error(db);
+	size_t const offset = tail - key.c_str();
+	tail = sql + offset;
+
+	// Statements keep their connection open until they are finalized, which
+	// may be after the database or the cache are gone.
+	std::shared_ptr<sqlite3> owner(db);
+	std::shared_ptr<sqlite3_stmt> ret(stmt, [owner](sqlite3_stmt* s) { sqlite3_finalize(s); });
+	if (stmt && capacity_ && found == index_.end()) {
+		lru_.push_front(entry{key, ret, offset});
+		index_.emplace(std::move(key), lru_.begin());
+		trim();
+		return hand_out(ret);
+	}
+	return ret;
+}
+
+void statement_cache::trim()
+{
+	while (lru_.size() > capacity_) {
+		index_.erase(lru_.back().sql);
+		lru_.pop_back();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 static int busy_handler_impl(void* p, int cnt)
 {
 	database::busy_handler* h(static_cast<database::busy_handler*>(p));
@@ -93,3 +159,66 @@ void database::set_authorize_handler(authorize_handler const& h)
 	ah_ = h;
 	sqlite3_set_authorizer(db_.get(), ah_ ? authorizer_impl : 0, &ah_);
 }
+
+//////////////////////////////////////////////////////////////////////////////
+
+database_pool::database_pool(char const* dbname, options const& opts)
+	: stats_()
+{
+	size_t const n = opts.size? opts.size : std::max(1u, std::thread::hardware_concurrency());
+	int const flags = SQLITE_OPEN_NOMUTEX
+		| (opts.readonly? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE));
+
+	for (size_t i = 0; i < n; ++i) {
+		std::unique_ptr<database> db(new database());
+		db->connect_v2(dbname, flags);
+		db->set_busy_timeout(opts.busy_timeout);
+		if (i == 0 && !opts.readonly) db->execute("PRAGMA journal_mode = WAL"); // persists in the file
+		db->set_statement_cache_size(opts.statement_cache_size);
+		if (opts.setup) opts.setup(*db);
+		free_.push_back(db.get());
+		all_.push_back(std::move(db));
+	}
+}
+
+database_pool::lease database_pool::acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	if (free_.empty()) {
+		auto const start = std::chrono::steady_clock::now();
+		available_.wait(lock, [this]() { return !free_.empty(); });
+		auto const waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		++stats_.waits;
+		stats_.wait_time += waited;
+		stats_.max_wait_time = std::max(stats_.max_wait_time, waited);
+	}
+	++stats_.leases;
+	database* db = free_.back();
+	free_.pop_back();
+	return lease(this, db);
+}
+
+database_pool::lease database_pool::try_acquire()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (free_.empty()) return lease();
+	++stats_.leases;
+	database* db = free_.back();
+	free_.pop_back();
+	return lease(this, db);
+}
+
+database_pool::stats database_pool::get_stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+void database_pool::give_back(database* db)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_.push_back(db);
+	}
+	available_.notify_one();
+}
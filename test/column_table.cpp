@@ -0,0 +1,63 @@
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	typedef std::tuple<int, std::string, double> row_t;
+	std::vector<row_t> const rows = {
+		std::make_tuple(3, "c", 1.5), std::make_tuple(1, "a", -2.0), std::make_tuple(2, "b", 4.25)
+	};
+
+	auto const table = qolor::from(rows).to_columns();
+	ECHO_IF_FAILED2("to_columns size", table.size() == 3 && !table.empty());
+	ECHO_IF_FAILED2("to_columns column", (table.column<0>() == std::vector<int>({ 3, 1, 2 })));
+	ECHO_IF_FAILED2("to_columns strings", (table.column<1>() == std::vector<std::string>({ "c", "a", "b" })));
+	ECHO_IF_FAILED2("to_columns row", table[2] == rows[2]);
+
+	// All the columns, as the rows they came from.
+	ECHO_IF_FAILED2("from table", qolor::from(table).to_vector() == rows);
+
+	// One column, contiguous.
+	ECHO_IF_FAILED2("from column sum", qolor::from<2>(table).sum() == 3.75);
+	ECHO_IF_FAILED2("from column min", qolor::from<0>(table).min() == 1);
+	ECHO_IF_FAILED2("from column max", qolor::from<2>(table).max() == 4.25);
+	ECHO_IF_FAILED2("from column count", qolor::from<1>(table).count("b") == 1);
+	ECHO_IF_FAILED2("from column where",
+		(qolor::from<0>(table).where([](int const& i) { return i > 1; }).to_vector() == std::vector<int>({ 3, 2 })));
+
+	// Some of the columns, in any order.
+	ECHO_IF_FAILED2("from columns", (qolor::from<2, 0>(table).to_vector() == std::vector<std::tuple<double, int>>({
+		std::make_tuple(1.5, 3), std::make_tuple(-2.0, 1), std::make_tuple(4.25, 2) })));
+	ECHO_IF_FAILED2("from columns order_by", (qolor::from<1, 2>(table)
+		.order_by([](std::tuple<std::string, double> const& t) { return std::get<1>(t); })
+		.to_vector() == std::vector<std::tuple<std::string, double>>({
+			std::make_tuple("a", -2.0), std::make_tuple("c", 1.5), std::make_tuple("b", 4.25) })));
+	ECHO_IF_FAILED2("from columns last", (qolor::from<0, 1>(table).last() == std::make_tuple(2, std::string("b"))));
+
+	// Converted columns, and a query as the source.
+	auto const converted = qolor::from(rows)
+		.select([](row_t const& r) { return std::make_tuple(std::get<0>(r), std::get<2>(r)); })
+		.to_columns<long, float>();
+	ECHO_IF_FAILED2("to_columns types", (converted.column<0>() == std::vector<long>({ 3, 1, 2 })
+		&& converted.column<1>() == std::vector<float>({ 1.5f, -2.0f, 4.25f })));
+
+	std::vector<std::pair<int, char>> const pairs = { { 1, 'x' }, { 2, 'y' } };
+	auto const from_pairs = qolor::from(pairs).to_columns();
+	ECHO_IF_FAILED2("to_columns pairs", (from_pairs.column<1>() == std::vector<char>({ 'x', 'y' })));
+
+	// A loaded CSV file, queried by column.
+	std::istringstream is("1,2,0.5,7\n1,3,1.5,7\n2,3,2.5,7\n");
+	auto const edges = qolor::from_csv<int, int, double, double>(is).to_columns();
+	ECHO_IF_FAILED2("to_columns csv", qolor::from<2>(edges).sum() == 4.5
+		&& qolor::from<0>(edges).count(1) == 2);
+
+	auto const empty = qolor::from(std::vector<row_t>()).to_columns();
+	ECHO_IF_FAILED2("to_columns empty", (empty.empty() && qolor::from<2>(empty).sum() == 0 && qolor::from<0, 1>(empty).to_vector().empty()));
+
+	return 0;
+}
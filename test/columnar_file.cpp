@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+std::string const path = "columnar_file_test.qcol";
+
+template <typename E>
+bool throws(std::function<void()> const& f)
+{
+	try { f(); }
+	catch (E const&) { return true; }
+	return false;
+}
+
+} // namespace
+
+int main()
+{
+	typedef std::tuple<int, std::string, double, bool, uint8_t> row_t;
+	std::vector<row_t> rows;
+	for (int i = 0; i < 1000; ++i)
+		rows.push_back(row_t(i, "name " + std::to_string(i % 13), i * 0.5, i % 3 == 0, uint8_t(i % 251)));
+
+	// Blocks of 64 rows, the last one partial.
+	qolor::from(rows).to_columnar_file(path, { "id", "name", "price", "flag", "small" }, 64);
+
+	ECHO_IF_FAILED2("columnar all columns", (qolor::from_columnar_file<int, std::string, double, bool, uint8_t>(path).to_vector() == rows));
+	ECHO_IF_FAILED2("columnar count", (qolor::from_columnar_file<int, std::string, double, bool, uint8_t>(path).count() == 1000));
+
+	// Some of the columns, by index or by name, in any order.
+	auto const prices = qolor::from_columnar_file<double>(path, qolor::columns({ 2 }))
+		.select([](std::tuple<double> const& t) { return std::get<0>(t); }).sum();
+	ECHO_IF_FAILED2("columnar one column", prices == 249750.0);
+	// Views point into the mapping of the file, which the query holds.
+	auto const by_name = qolor::from_columnar_file<qolor::text_view, int>(path, qolor::columns({ "name", "id" }));
+	auto const named = by_name.to_vector();
+	ECHO_IF_FAILED2("columnar by name", (named.size() == 1000 && std::get<0>(named[27]) == "name 1" && std::get<1>(named[27]) == 27));
+
+	// Ranges skip blocks and rows.
+	auto const in_range = qolor::from_columnar_file<int>(path, qolor::columns({ "id" }), qolor::field_filter().between(0, 100, 130))
+		.select([](std::tuple<int> const& t) { return std::get<0>(t); }).to_vector();
+	ECHO_IF_FAILED2("columnar range", (in_range == qolor::range(100, 131).to_vector()));
+	auto const two_ranges = qolor::from_columnar_file<int, double>(path, qolor::columns({ 0, 2 }),
+		qolor::field_filter().between(0, 0, 500).between(2, 240, 1e9)).count();
+	ECHO_IF_FAILED2("columnar two ranges", two_ranges == 21);
+	ECHO_IF_FAILED2("columnar range none", (qolor::from_columnar_file<int>(path, qolor::columns({ 0 }),
+		qolor::field_filter().between(4, 251, 300)).count() == 0));
+
+	// Types and columns must match the file.
+	ECHO_IF_FAILED2("columnar wrong type", throws<std::invalid_argument>([]() { qolor::from_columnar_file<double>(path, qolor::columns({ 0 })); }));
+	ECHO_IF_FAILED2("columnar wrong count", throws<std::invalid_argument>([]() { qolor::from_columnar_file<int, double>(path); }));
+	ECHO_IF_FAILED2("columnar unknown name", throws<std::invalid_argument>([]() { qolor::from_columnar_file<int>(path, qolor::columns({ "weight" })); }));
+	ECHO_IF_FAILED2("columnar string range", throws<std::invalid_argument>([]() {
+		qolor::from_columnar_file<int>(path, qolor::columns({ 0 }), qolor::field_filter().between(1, 0, 1)); }));
+	ECHO_IF_FAILED2("columnar text filter", throws<std::invalid_argument>([]() {
+		qolor::from_columnar_file<int>(path, qolor::columns({ 0 }), qolor::field_filter().equals(1, "x")); }));
+
+	// From a CSV file, as a restart would.
+	{
+		std::istringstream is("1,2,0.5\n1,3,1.5\n2,3,2.5\n");
+		qolor::from_csv<int, int, double>(is).to_columnar_file(path);
+		ECHO_IF_FAILED2("columnar from csv", (qolor::from_columnar_file<int, int, double>(path).to_vector()
+			== std::vector<std::tuple<int, int, double>>({ std::make_tuple(1, 2, 0.5), std::make_tuple(1, 3, 1.5), std::make_tuple(2, 3, 2.5) })));
+	}
+
+	std::vector<std::pair<long, float>> const pairs;
+	qolor::from(pairs).to_columnar_file(path);
+	ECHO_IF_FAILED2("columnar empty", (qolor::from_columnar_file<long, float>(path).count() == 0));
+
+	{
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		os << "id,name\n1,a\n";
+	}
+	ECHO_IF_FAILED2("columnar not a columnar file", throws<std::runtime_error>([]() { qolor::from_columnar_file<int>(path); }));
+	std::remove(path.c_str());
+
+	return 0;
+}
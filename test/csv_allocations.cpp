@@ -0,0 +1,112 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+// Every heap allocation of the program is counted.
+namespace
+{
+size_t allocations = 0;
+size_t allocated = 0; // bytes
+} // namespace
+
+void* operator new(size_t size)
+{
+	++allocations;
+	allocated += size;
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace
+{
+
+// Rows with the same widths, some of them past the small string buffer, with
+// quoted and escaped fields.
+std::string make_text(size_t const& rows)
+{
+	std::string text;
+	for (size_t i = 0; i < rows; ++i) {
+		char line[128];
+		std::snprintf(line, sizeof(line), "%06zu,a text field that is not short %04zu,\"quoted, \"\"%03zu\"\"\",%08.3f\n",
+			i, i % 10000, i % 1000, double(i % 100000) / 8);
+		text += line;
+	}
+	return text;
+}
+
+// Allocations while reading the second half of the rows, once the buffers
+// of the drivers have grown (the index windows of the mapped driver grow over
+// the first few kilobytes).
+template <typename Iterable>
+size_t steady_allocations(Iterable&& q, size_t& rows)
+{
+	size_t before = 0;
+	rows = 0;
+	for (auto const& row : q) {
+		if (++rows == 500) before = allocations;
+		(void)row;
+	}
+	return allocations - before;
+}
+
+} // namespace
+
+int main()
+{
+	std::string const text = make_text(1000);
+	size_t rows;
+
+	{
+		std::istringstream is(text);
+		size_t const n = steady_allocations(qolor::from_csv(is), rows);
+		ECHO_IF_FAILED2("from_csv rows", rows == 1000);
+		ECHO_IF_FAILED2("from_csv allocations", n == 0);
+	}
+	{
+		std::istringstream is(text);
+		size_t const n = steady_allocations(qolor::from_csv(is, qolor::columns({ 2, 1 })), rows);
+		ECHO_IF_FAILED2("from_csv columns allocations", n == 0);
+	}
+	{
+		std::istringstream is(text);
+		size_t const n = steady_allocations(qolor::from_csv<int, std::string, qolor::text_view, double>(is), rows);
+		ECHO_IF_FAILED2("from_csv typed rows", rows == 1000);
+		// The std::string of every tuple.
+		ECHO_IF_FAILED2("from_csv typed allocations", n == rows - 500);
+	}
+
+	std::string const path = "csv_allocations_test.csv";
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+	{
+		size_t const n = steady_allocations(qolor::from_csv_file(path), rows);
+		ECHO_IF_FAILED2("from_csv_file rows", rows == 1000);
+		ECHO_IF_FAILED2("from_csv_file allocations", n == 0);
+	}
+	{
+		// Copies of an iterator share the index of its window, until they
+		// move past it.
+		auto q = qolor::from_csv_file(path);
+		auto i = q.begin();
+		for (size_t k = 0; k < 500; ++k) ++i;
+		size_t const before = allocated;
+		auto copy = i;
+		ECHO_IF_FAILED2("from_csv_file copy", (allocated - before < qolor::internal::csv::row_parser::window_size));
+		bool same = true;
+		for (size_t k = 500; k < 1000; ++k, ++i, ++copy) same = same && (*i).to_strings() == (*copy).to_strings();
+		ECHO_IF_FAILED2("from_csv_file copies", (same && i == q.end() && copy == q.end()));
+	}
+	std::remove(path.c_str());
+
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+#include "csv_testutil.h"
+
+namespace
+{
+
+std::string const text =
+	"id,name,\"note, quoted\",price,qty\n"
+	"1,apple,\"red, \"\"fresh\"\"\",0.5,10\n"
+	"\n"
+	"2,pear,,1.25,3\r\n"
+	"3,\"fig\"\n";
+
+} // namespace
+
+int main()
+{
+	rows_t const by_index = { { "price", "id" }, { "0.5", "1" }, { "1.25", "2" }, { "", "3" } };
+	rows_t const by_name = { { "0.5", "red, \"fresh\"" }, { "1.25", "" }, { "", "" } };
+
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv columns by index", (strings(qolor::from_csv(is, qolor::columns({ 3, 0 }))) == by_index));
+	}
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv columns by name",
+			(strings(qolor::from_csv(is, qolor::columns({ "price", "note, quoted" }))) == by_name));
+	}
+	{
+		std::istringstream is("\"a\",\"b \"\"c\"\"\"\n");
+		ECHO_IF_FAILED2("from_csv quoted", (strings(qolor::from_csv(is)) == rows_t({ { "a", "b \"c\"" } })));
+	}
+	{
+		std::istringstream is("a;b;c\n1;2;3\n");
+		ECHO_IF_FAILED2("from_delimited columns", (strings(qolor::from_delimited(is, std::string(";"), qolor::columns({ "c" })))
+			== rows_t({ { "3" } })));
+	}
+	{
+		std::istringstream is(text);
+		auto rows = qolor::from_csv<double, int>(is, qolor::columns({ "price", "qty" })).to_vector();
+		ECHO_IF_FAILED2("from_csv typed columns", (rows == std::vector<std::tuple<double, int>>({
+			std::make_tuple(0.5, 10), std::make_tuple(1.25, 3), std::make_tuple(0.0, 0) })));
+	}
+
+	std::string const path = "csv_columns_test.csv";
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+	ECHO_IF_FAILED2("from_csv_file columns by index", (views(qolor::from_csv_file(path, qolor::columns({ 3, 0 }))) == by_index));
+	ECHO_IF_FAILED2("from_csv_file columns by name",
+		(views(qolor::from_csv_file(path, qolor::columns({ "price", "note, quoted" }))) == by_name));
+	ECHO_IF_FAILED2("from_csv_file typed columns", (qolor::from_csv_file<std::string>(path, qolor::columns({ "name" }))
+		.select([](std::tuple<std::string> const& t) { return std::get<0>(t); })
+		.to_vector() == std::vector<std::string>({ "apple", "pear", "fig" })));
+
+	// Chunks of every size, so that the header and the skipped fields are cut
+	// in every possible place.
+	ECHO_IF_FAILED2("from_csv_file_parallel columns",
+		same_rows_in_all_chunks(path, text.size(), by_name, qolor::columns({ "price", "note, quoted" })));
+	ECHO_IF_FAILED2("from_csv_file_parallel columns by index",
+		(views(qolor::from_csv_file_parallel(path, qolor::columns({ 3, 0 }), 2)) == by_index));
+
+	bool thrown = false;
+	try { qolor::from_csv_file(path, qolor::columns({ "weight" })); }
+	catch (std::invalid_argument const&) { thrown = true; }
+	ECHO_IF_FAILED2("columns unknown name", thrown);
+	std::remove(path.c_str());
+
+	thrown = false;
+	try { qolor::columns({ 1, 2, 1 }); }
+	catch (std::invalid_argument const&) { thrown = true; }
+	ECHO_IF_FAILED2("columns repeated", thrown);
+
+	return 0;
+}
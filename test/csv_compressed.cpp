@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+#include <zlib.h>
+#include <qolor/all.hpp>
+#include "testfn.h"
+#include "csv_testutil.h"
+
+namespace
+{
+
+std::string const path = "csv_compressed_test.csv.gz";
+
+void write_gzip(std::string const& text)
+{
+	gzFile f = gzopen(path.c_str(), "wb");
+	gzwrite(f, text.data(), unsigned(text.size()));
+	gzclose(f);
+}
+
+} // namespace
+
+int main()
+{
+	std::string text = "id,name,price\n";
+	rows_t rows = { { "id", "name", "price" } };
+	for (int i = 0; i < 20000; ++i) {
+		std::string const id = std::to_string(i), name = "item \"" + std::to_string(i * 7) + "\"", price = std::to_string(i % 97) + ".5";
+		text += id + ",\"item \"\"" + std::to_string(i * 7) + "\"\"\"," + price + "\r\n";
+		rows.push_back({ id, name, price });
+	}
+
+	write_gzip(text);
+	ECHO_IF_FAILED2("from_csv_compressed", views(qolor::from_csv_compressed(path)) == rows);
+	ECHO_IF_FAILED2("from_csv_compressed columns",
+		views(qolor::from_csv_compressed(path, qolor::columns({ "price" }))).size() == rows.size() - 1);
+	ECHO_IF_FAILED2("from_csv_compressed typed", (qolor::from_csv_compressed<int, std::string, double>(path, qolor::columns({ "id", "name", "price" }))
+		.where([](std::tuple<int, std::string, double> const& t) { return std::get<0>(t) == 9999; })
+		.to_vector() == std::vector<std::tuple<int, std::string, double>>({ std::make_tuple(9999, "item \"69993\"", 8.5) })));
+
+	// Buffers smaller than a line, so that lines span several of them.
+	{
+		qolor::utils::compressed_istream is(path, 7, 2);
+		std::string line, all;
+		while (std::getline(is, line)) all += line + '\n';
+		ECHO_IF_FAILED2("compressed_istream small buffers", all == text);
+	}
+
+	// Not compressed.
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << "a,b\n1,2\n";
+	}
+	ECHO_IF_FAILED2("from_csv_compressed plain", (views(qolor::from_csv_compressed(path)) == rows_t({ { "a", "b" }, { "1", "2" } })));
+
+	// Truncated.
+	write_gzip(text);
+	{
+		std::ifstream is(path, std::ios::binary);
+		std::string gz((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		os << gz.substr(0, gz.size() / 2);
+	}
+	bool thrown = false;
+	try { views(qolor::from_csv_compressed(path)); }
+	catch (std::runtime_error const&) { thrown = true; }
+	ECHO_IF_FAILED2("from_csv_compressed truncated", thrown);
+	std::remove(path.c_str());
+
+	thrown = false;
+	try { qolor::from_csv_compressed("no_such_file.csv.gz"); }
+	catch (std::system_error const&) { thrown = true; }
+	ECHO_IF_FAILED2("from_csv_compressed missing file", thrown);
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+typedef std::vector<std::vector<std::string>> rows_t;
+
+std::string const path = "csv_file_test.csv";
+
+rows_t read(std::string const& contents, char const& sep = ',')
+{
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << contents;
+	}
+	rows_t rows;
+	for (auto const& row : qolor::from_csv_file(path, sep))
+		rows.push_back(row.to_strings());
+	std::remove(path.c_str());
+	return rows;
+}
+
+} // namespace
+
+int main()
+{
+	ECHO_IF_FAILED2("csv file plain", (read("a,b,c\n1,2,3\n") == rows_t({ { "a", "b", "c" }, { "1", "2", "3" } })));
+	ECHO_IF_FAILED2("csv file no final newline", (read("a,b\n1,2") == rows_t({ { "a", "b" }, { "1", "2" } })));
+	ECHO_IF_FAILED2("csv file crlf", (read("a,b\r\n1,2\r\n") == rows_t({ { "a", "b" }, { "1", "2" } })));
+	ECHO_IF_FAILED2("csv file empty lines", (read("\n\na\n\r\n\nb\n\n") == rows_t({ { "a" }, { "b" } })));
+	ECHO_IF_FAILED2("csv file empty fields", (read(",x,\n,\n") == rows_t({ { "", "x", "" }, { "", "" } })));
+	ECHO_IF_FAILED2("csv file trailing separator", (read("a,") == rows_t({ { "a", "" } })));
+	ECHO_IF_FAILED2("csv file separator", (read("a;b,c\n", ';') == rows_t({ { "a", "b,c" } })));
+	ECHO_IF_FAILED2("csv file empty", (read("").empty()));
+	ECHO_IF_FAILED2("csv file only newlines", (read("\r\n\n").empty()));
+
+	ECHO_IF_FAILED2("csv file quoted", (read("\"a,b\",\"\",c\n") == rows_t({ { "a,b", "", "c" } })));
+	ECHO_IF_FAILED2("csv file escaped quotes",
+		(read("\"say \"\"hi\"\"\",\"\"\"\"\n") == rows_t({ { "say \"hi\"", "\"" } })));
+	ECHO_IF_FAILED2("csv file quoted newline",
+		(read("\"line 1\nline 2\",x\r\ny\n") == rows_t({ { "line 1\nline 2", "x" }, { "y" } })));
+	ECHO_IF_FAILED2("csv file quoted crlf", (read("\"a\"\r\n\"b\"") == rows_t({ { "a" }, { "b" } })));
+	ECHO_IF_FAILED2("csv file unterminated quote", (read("\"abc") == rows_t({ { "abc" } })));
+
+	// Fields are views into the mapping, unless they had to be unescaped.
+	{
+		{
+			std::ofstream os(path, std::ios::binary);
+			os << "abc,\"d\"\"e\",\"f\"\n";
+		}
+		auto q = qolor::from_csv_file(path);
+		auto const& row = *q.begin();
+		bool ok = (row.size() == 3) && (row[0] == "abc") && (row[1] == "d\"e") && (row[2] == "f");
+		ok = ok && (row[2].data() == row[0].data() + 12);
+		ECHO_IF_FAILED2("csv file views", ok);
+		ECHO_IF_FAILED2("csv file row iteration", (std::vector<qolor::text_view>(row.begin(), row.end())
+			== std::vector<qolor::text_view>({ "abc", "d\"e", "f" })));
+		std::remove(path.c_str());
+	}
+
+	// Queries keep the mapping alive.
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << "1,x\n2,y\n3,z\n";
+	}
+	auto names = qolor::from_csv_file(path)
+		.where([](qolor::internal::csv::mapped_row const& r) { return r[0] != "2"; })
+		.select([](qolor::internal::csv::mapped_row const& r) { return r[1].str(); })
+		.to_vector();
+	std::remove(path.c_str());
+	ECHO_IF_FAILED2("csv file query", (names == std::vector<std::string>({ "x", "z" })));
+
+	// Enough rows to span many windows of the index, with quoted separators
+	// and newlines across their boundaries.
+	{
+		rows_t expected;
+		std::string contents;
+		for (size_t i = 0; i < 20000; ++i) {
+			std::string const a = std::to_string(i);
+			std::string const b = (i % 3)? "x,\"" + a + "\"\ny" : "";
+			expected.push_back({ a, b, "z" });
+			contents += a + ",\"" + ((i % 3)? "x,\"\"" + a + "\"\"\ny" : "") + "\",z" + ((i % 2)? "\r\n" : "\n");
+		}
+		ECHO_IF_FAILED2("csv file windows", (read(contents) == expected));
+	}
+
+	bool thrown = false;
+	try { qolor::from_csv_file("no_such_file.csv"); }
+	catch (std::system_error const&) { thrown = true; }
+	ECHO_IF_FAILED2("csv file missing", thrown);
+
+	return 0;
+}
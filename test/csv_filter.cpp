@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+#include "csv_testutil.h"
+
+namespace
+{
+
+std::string const text =
+	"id,country,city,price\n"
+	"1,FR,Paris,12.5\n"
+	"2,DE,\"Berlin, Mitte\",30\n"
+	"\n"
+	"3,FR,\"Lyon \"\"2\"\"\",n/a\r\n"
+	"4,\"FR\",Lille,  18 \n"
+	"5,ES\n"
+	"6,FR,Nice,\"\"\n";
+
+} // namespace
+
+int main()
+{
+	qolor::columns const all;
+	qolor::columns const by_name({ "city", "id" });
+	qolor::field_filter const fr = qolor::field_filter().equals(1, "FR");
+	qolor::field_filter const cheap_fr = qolor::field_filter().equals(1, "FR").between(3, 10, 20);
+	qolor::field_filter const quoted = qolor::field_filter().starts_with(2, "Lyon \"");
+
+	rows_t const fr_rows = { { "id", "country", "city", "price" }, { "1", "FR", "Paris", "12.5" },
+		{ "3", "FR", "Lyon \"2\"", "n/a" }, { "4", "FR", "Lille", "  18 " }, { "6", "FR", "Nice", "" } };
+	rows_t const cheap_fr_rows = { { "Paris", "1" }, { "Lille", "4" } };
+	rows_t const quoted_rows = { { "3", "FR", "Lyon \"2\"", "n/a" } };
+
+	// The header is a row too when the columns are not by name.
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv equals", (strings(qolor::from_csv(is, all, fr)) == rows_t(fr_rows.begin() + 1, fr_rows.end())));
+	}
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv between", (strings(qolor::from_csv(is, by_name, cheap_fr)) == cheap_fr_rows));
+	}
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv starts_with quoted", (strings(qolor::from_csv(is, all, quoted)) == quoted_rows));
+	}
+	{
+		std::istringstream is(text);
+		auto rows = qolor::from_csv<int, double>(is, qolor::columns({ "id", "price" }), cheap_fr).to_vector();
+		ECHO_IF_FAILED2("from_csv typed filter", (rows == std::vector<std::tuple<int, double>>({
+			std::make_tuple(1, 12.5), std::make_tuple(4, 18.0) })));
+	}
+	{
+		std::istringstream is(text);
+		ECHO_IF_FAILED2("from_csv missing column", (strings(qolor::from_csv(is, all, qolor::field_filter().equals(1, "ES")))
+			== rows_t({ { "5", "ES" } })));
+	}
+	{
+		// Filters are on narrow text only.
+		std::wistringstream is(L"id,country\n1,FR\n2,DE\n");
+		bool thrown = false;
+		try { qolor::from_csv(is, all, fr); }
+		catch (std::invalid_argument const&) { thrown = true; }
+		ECHO_IF_FAILED2("from_csv wide filter", thrown);
+		std::wistringstream unfiltered(L"id,country\n1,FR\n2,DE\n");
+		ECHO_IF_FAILED2("from_csv wide no filter", (qolor::from_csv(unfiltered, qolor::columns({ "country" })).count() == 2));
+	}
+
+	std::string const path = "csv_filter_test.csv";
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << text;
+	}
+	ECHO_IF_FAILED2("from_csv_file equals", (views(qolor::from_csv_file(path, all, fr)) == rows_t(fr_rows.begin() + 1, fr_rows.end())));
+	ECHO_IF_FAILED2("from_csv_file between", (views(qolor::from_csv_file(path, by_name, cheap_fr)) == cheap_fr_rows));
+	ECHO_IF_FAILED2("from_csv_file starts_with quoted", (views(qolor::from_csv_file(path, all, quoted)) == quoted_rows));
+	ECHO_IF_FAILED2("from_csv_file typed filter", (qolor::from_csv_file<std::string>(path, qolor::columns({ "city" }), cheap_fr)
+		.select([](std::tuple<std::string> const& t) { return std::get<0>(t); })
+		.to_vector() == std::vector<std::string>({ "Paris", "Lille" })));
+	ECHO_IF_FAILED2("from_csv_file no match", views(qolor::from_csv_file(path, all, qolor::field_filter().equals(0, "7"))).empty());
+
+	// Chunks of every size, so that the filtered rows are cut in every
+	// possible place.
+	ECHO_IF_FAILED2("from_csv_file_parallel filter", same_rows_in_all_chunks(path, text.size(), cheap_fr_rows, by_name, cheap_fr));
+	ECHO_IF_FAILED2("from_csv_file_parallel equals",
+		(views(qolor::from_csv_file_parallel(path, all, fr, 2)) == rows_t(fr_rows.begin() + 1, fr_rows.end())));
+	std::remove(path.c_str());
+
+	return 0;
+}
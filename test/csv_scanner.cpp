@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <qolor/csv_scanner.h>
+#include "testfn.h"
+
+namespace
+{
+
+// One byte at a time.
+std::vector<uint32_t> reference(std::string const& s, char const& sep)
+{
+	std::vector<uint32_t> ret;
+	bool quoted = false;
+	for (size_t i = 0; i < s.size(); ++i) {
+		if (s[i] == '"') quoted = !quoted;
+		else if (!quoted && (s[i] == sep || s[i] == '\n')) ret.push_back(uint32_t(i));
+	}
+	return ret;
+}
+
+// In parts of the given size, carrying the quote state over.
+std::vector<uint32_t> scan(std::string const& s, char const& sep, size_t const& part)
+{
+	std::vector<uint32_t> ret, buf(part);
+	uint64_t in_quotes = 0;
+	for (size_t b = 0; b < s.size(); b += part) {
+		size_t const n = std::min(part, s.size() - b);
+		size_t const k = qolor::internal::csv::scan_structurals(s.data() + b, n, sep, in_quotes, buf.data());
+		for (size_t i = 0; i < k; ++i) ret.push_back(uint32_t(b + buf[i]));
+	}
+	return ret;
+}
+
+} // namespace
+
+int main()
+{
+	using qolor::internal::csv::scan_structurals;
+
+	uint32_t out[256];
+	uint64_t in_quotes = 0;
+	ECHO_IF_FAILED2("scan empty", (scan_structurals("", 0, ',', in_quotes, out) == 0 && in_quotes == 0));
+
+	std::string const s = "a,\"b,\"\"c\n\",d\ne";
+	size_t const k = scan_structurals(s.data(), s.size(), ',', in_quotes, out);
+	ECHO_IF_FAILED2("scan quoted", (std::vector<uint32_t>(out, out + k) == std::vector<uint32_t>({ 1, 10, 12 })));
+
+	std::string const open = "x,\"y";
+	scan_structurals(open.data(), open.size(), ',', in_quotes, out);
+	ECHO_IF_FAILED2("scan ends in quotes", (in_quotes == ~uint64_t(0)));
+	ECHO_IF_FAILED2("scan carries quotes", (scan_structurals(",\",", 3, ',', in_quotes, out) == 1 && out[0] == 2));
+
+	// Random text, dense in structurals and quotes, in parts that do and do not
+	// line up with the blocks of the scanner.
+	std::mt19937 gen(7);
+	char const alphabet[] = "ab,;\"\n\r ";
+	for (size_t size : { 1, 63, 64, 65, 200, 5000 }) {
+		std::string text(size, ' ');
+		for (auto& c : text) c = alphabet[gen() % (sizeof(alphabet) - 1)];
+		for (char sep : { ',', ';', ' ' }) {
+			auto const expected = reference(text, sep);
+			bool ok = true;
+			for (size_t part : { 1, 7, 64, 100, 128, 8192 })
+				ok = ok && (scan(text, sep, part) == expected);
+			ECHO_IF_FAILED2("scan random " + std::to_string(size) + " '" + sep + "'", ok);
+		}
+	}
+
+	return 0;
+}
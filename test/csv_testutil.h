@@ -0,0 +1,45 @@
+#ifndef QOLOR_UTILS_CSV_TESTUTIL_H__
+#define QOLOR_UTILS_CSV_TESTUTIL_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+
+typedef std::vector<std::vector<std::string>> rows_t;
+
+// Rows of fields that are strings.
+template <typename Iterable>
+rows_t strings(Iterable&& q)
+{
+	rows_t ret;
+	for (auto const& row : q) ret.push_back(std::vector<std::string>(row.begin(), row.end()));
+	return ret;
+}
+
+// Rows of fields that are views (of mapped files).
+template <typename Iterable>
+rows_t views(Iterable&& q)
+{
+	rows_t ret;
+	for (auto const& row : q) ret.push_back(row.to_strings());
+	return ret;
+}
+
+// Whether the parallel reader returns expected from the file at path, of
+// size bytes, in chunks of every size, so that its rows are cut in every
+// possible place.
+inline bool same_rows_in_all_chunks(std::string const& path, size_t const& size, rows_t const& expected,
+	qolor::columns const& cols, qolor::field_filter const& filter = qolor::field_filter())
+{
+	for (size_t chunk_size = 1; chunk_size < size + 2; ++chunk_size) {
+		typedef qolor::internal::csv::parallel_csv_iterator iter_t;
+		auto file = std::make_shared<qolor::utils::mapped_file>(path);
+		auto state = std::make_shared<qolor::internal::csv::parallel_csv_state>(file, ',', 2, qolor::row_order::source,
+			cols, filter, chunk_size);
+		if (views(qolor::internal::iterable<iter_t>(iter_t(state), iter_t())) != expected) return false;
+	}
+	return true;
+}
+
+#endif // QOLOR_UTILS_CSV_TESTUTIL_H__
@@ -23,10 +23,7 @@ int main()
 	if (!success)
 		return -1;
 
-	auto iterable = qolor::from_csv(input)
-		.select([](const std::vector<std::string>& v) {
-			return std::make_tuple(std::stoi(v[0]), std::stoi(v[1]), std::stod(v[2]), std::stod(v[3]));
-		});
+	auto iterable = qolor::from_csv<int, int, double, double>(input);
 
 	for (auto const& v : iterable) {
 		int node0 = std::get<0>(v);
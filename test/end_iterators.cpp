@@ -0,0 +1,71 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+// Predicate that counts how many times it is copied.
+struct counted_pred
+{
+	static int copies;
+	std::vector<int> heavy;
+
+	counted_pred() : heavy(1000, 1) {}
+	counted_pred(counted_pred const& o) : heavy(o.heavy) { ++copies; }
+	counted_pred(counted_pred&&) = default;
+
+	bool operator()(int const& x) const { return x % 2 == 0; }
+};
+
+int counted_pred::copies = 0;
+
+} // namespace
+
+int main()
+{
+	std::vector<int> numbers { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	// Only the begin iterator carries the predicate.
+	counted_pred pred;
+	counted_pred::copies = 0;
+	auto evens = qolor::from(numbers).where(pred);
+	ECHO_IF_FAILED2("end iterator does not copy the predicate", (counted_pred::copies == 1));
+	ECHO_IF_FAILED2("where over sentinel", (evens.to_vector() == std::vector<int>({ 2, 4, 6, 8 })));
+
+	std::vector<int> pulled;
+	for (auto const& x : evens) pulled.push_back(x);
+	ECHO_IF_FAILED2("pull loop over sentinel", (pulled == std::vector<int>({ 2, 4, 6, 8 })));
+	ECHO_IF_FAILED2("begin != end", (evens.begin() != evens.end()));
+	ECHO_IF_FAILED2("end == end", (evens.end() == evens.end()));
+
+	auto none = qolor::from(numbers).where([](int const& x) { return x > 100; });
+	ECHO_IF_FAILED2("empty where", (none.empty() && none.end() == none.begin()));
+
+	auto prefix = qolor::from(numbers).take_while([](int const& x) { return x < 4; });
+	ECHO_IF_FAILED2("take_while over sentinel", (prefix.to_vector() == std::vector<int>({ 1, 2, 3 })));
+	std::vector<int> taken;
+	for (auto const& x : qolor::from(numbers).take(3)) taken.push_back(x);
+	ECHO_IF_FAILED2("take pull loop", (taken == std::vector<int>({ 1, 2, 3 })));
+
+	// Generators.
+	int next = 0;
+	auto gen = qolor::from([&next]() { return next++; }, [](int const& x) { return x < 5; });
+	std::vector<int> generated;
+	for (auto const& x : gen) generated.push_back(x);
+	ECHO_IF_FAILED2("generator over sentinel", (generated == std::vector<int>({ 0, 1, 2, 3, 4 })));
+
+	// Delimited text, including repeated and empty lines.
+	std::istringstream csv("a,1\nb,2\n\nb,2\nc,3\n");
+	std::vector<std::string> keys;
+	for (auto const& row : qolor::from_csv(csv)) keys.push_back(row[0]);
+	ECHO_IF_FAILED2("csv over sentinel", (keys == std::vector<std::string>({ "a", "b", "b", "c" })));
+
+	std::istringstream empty_csv("");
+	ECHO_IF_FAILED2("empty csv", (qolor::from_csv(empty_csv).empty()));
+
+	return 0;
+}
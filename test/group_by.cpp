@@ -0,0 +1,65 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	typedef std::tuple<std::string,int> sale_t;
+	std::vector<sale_t> sales {
+		std::make_tuple("apples", 3), std::make_tuple("pears", 5), std::make_tuple("apples", 4),
+		std::make_tuple("plums", 1), std::make_tuple("pears", 2), std::make_tuple("apples", 7)
+	};
+
+	auto qty = [](sale_t const& s) { return std::get<1>(s); };
+	auto groups = qolor::from(sales)
+		.group_by([](sale_t const& s) { return std::get<0>(s); },
+			qolor::agg::count(), qolor::agg::sum(qty), qolor::agg::min(qty), qolor::agg::max(qty));
+
+	ECHO_IF_FAILED2("group count", (groups.size() == 3));
+
+	// Groups keep the order of their first element.
+	std::vector<std::string> keys;
+	for (auto const& g : groups) keys.push_back(g.first);
+	std::vector<std::string> expected_keys { "apples", "pears", "plums" };
+	ECHO_IF_FAILED2("group order", (keys == expected_keys));
+
+	auto const& apples = groups.find("apples")->second;
+	ECHO_IF_FAILED2("group_by count", (std::get<0>(apples) == 3));
+	ECHO_IF_FAILED2("group_by sum", (std::get<1>(apples) == 14));
+	ECHO_IF_FAILED2("group_by min", (std::get<2>(apples) == 3));
+	ECHO_IF_FAILED2("group_by max", (std::get<3>(apples) == 7));
+	ECHO_IF_FAILED2("group_by missing key", (groups.find("kiwis") == groups.end()));
+
+	// Plain binary functionals and folds.
+	std::vector<int> numbers;
+	for (int i = 0; i < 1000; ++i) numbers.push_back(i);
+	auto by_mod = qolor::from(numbers)
+		.where([](int const& x) { return x % 2 == 0; })
+		.group_by([](int const& x) { return x % 10; },
+			[](int const& a, int const& b) { return a + b; },
+			qolor::agg::fold(std::string(), [](std::string const& s, int const& x) {
+				return s.size() < 3? s + char('0' + x % 10) : s;
+			}));
+	ECHO_IF_FAILED2("group_by after where", (by_mod.size() == 5));
+	ECHO_IF_FAILED2("group_by binary functional", (std::get<0>(by_mod.find(4)->second) == 49900));
+	ECHO_IF_FAILED2("group_by fold", (std::get<1>(by_mod.find(4)->second) == "444"));
+
+	// Input-only source, consumed in one pass.
+	std::istringstream csv("a,1\nb,2\na,3\nc,4\nb,5\n");
+	auto csv_groups = qolor::from_csv(csv)
+		.group_by([](std::vector<std::string> const& r) { return r[0]; },
+			qolor::agg::collect(), qolor::agg::count());
+	ECHO_IF_FAILED2("group_by input-only source", (csv_groups.size() == 3));
+	ECHO_IF_FAILED2("group_by collect", (std::get<0>(csv_groups.find("b")->second).size() == 2));
+	ECHO_IF_FAILED2("group_by collect values", (std::get<0>(csv_groups.find("b")->second)[1][1] == "5"));
+	ECHO_IF_FAILED2("group_by csv count", (std::get<1>(csv_groups.find("a")->second) == 2));
+
+	std::vector<int> empty;
+	ECHO_IF_FAILED2("group_by empty", (qolor::from(empty).group_by([](int const& x) { return x; }, qolor::agg::count()).empty()));
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	std::vector<std::tuple<int,std::string>> people {
+		std::make_tuple(1, "alice"), std::make_tuple(2, "bob"), std::make_tuple(3, "carol")
+	};
+	std::vector<std::tuple<int,double>> orders {
+		std::make_tuple(1, 10.0), std::make_tuple(3, 5.5), std::make_tuple(1, 2.5),
+		std::make_tuple(4, 100.0), std::make_tuple(3, 1.0)
+	};
+
+	typedef std::tuple<int,std::string> person_t;
+	typedef std::tuple<int,double> order_t;
+
+	// Left side is smaller and both are random access: the table is built over the left side.
+	auto joined = qolor::from(people)
+		.join_on(qolor::from(orders),
+			[](person_t const& p) { return std::get<0>(p); },
+			[](order_t const& o) { return std::get<0>(o); })
+		.to_vector();
+
+	ECHO_IF_FAILED2("hash join row count", (joined.size() == 4));
+
+	double alice = 0, carol = 0;
+	for (auto const& r : joined) {
+		ECHO_IF_FAILED2("hash join keys match", (std::get<0>(r) == std::get<2>(r)));
+		if (std::get<1>(r) == "alice") alice += std::get<3>(r);
+		if (std::get<1>(r) == "carol") carol += std::get<3>(r);
+	}
+	ECHO_IF_FAILED2("hash join alice", (alice == 12.5));
+	ECHO_IF_FAILED2("hash join carol", (carol == 6.5));
+
+	// Input-only right side.
+	std::istringstream csv("1,red\n2,green\n2,blue\n5,black\n");
+	std::vector<std::string> colors;
+	auto colored = qolor::from(people)
+		.join_on(qolor::from_csv(csv),
+			[](person_t const& p) { return std::to_string(std::get<0>(p)); },
+			[](std::vector<std::string> const& v) { return v[0]; })
+		.select([](std::tuple<int,std::string,std::vector<std::string>> const& r) {
+			return std::get<1>(r) + ":" + std::get<2>(r)[1];
+		});
+	for (auto const& c : colored) colors.push_back(c);
+
+	std::sort(colors.begin(), colors.end());
+	std::vector<std::string> expected { "alice:red", "bob:blue", "bob:green" };
+	ECHO_IF_FAILED2("hash join with input-only source", (colors == expected));
+
+	auto none = qolor::from(people)
+		.join_on(qolor::from(orders).where([](order_t const& o) { return std::get<0>(o) > 10; }),
+			[](person_t const& p) { return std::get<0>(p); },
+			[](order_t const& o) { return std::get<0>(o); });
+	ECHO_IF_FAILED2("hash join without matches", none.empty());
+
+	// Post-increment gives the row it was at.
+	auto rows = qolor::from(people)
+		.join_on(qolor::from(orders),
+			[](person_t const& p) { return std::get<0>(p); },
+			[](order_t const& o) { return std::get<0>(o); });
+	auto i = rows.begin();
+	auto const first = *i;
+	auto const old = *i++;
+	ECHO_IF_FAILED2("hash join post-increment", (old == first && *i != first));
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	typedef std::tuple<std::string,int> row_t;
+	std::vector<row_t> rows {
+		std::make_tuple("a", 5), std::make_tuple("b", 2), std::make_tuple("c", 9),
+		std::make_tuple("d", 2), std::make_tuple("e", 7), std::make_tuple("f", 5)
+	};
+	auto score = [](row_t const& r) { return std::get<1>(r); };
+	auto names = [](std::vector<row_t> const& v) {
+		std::string s;
+		for (auto const& r : v) s += std::get<0>(r);
+		return s;
+	};
+
+	// Equal keys keep the source order.
+	ECHO_IF_FAILED2("order_by", (names(qolor::from(rows).order_by(score).to_vector()) == "bdafec"));
+	ECHO_IF_FAILED2("order_by_descending", (names(qolor::from(rows).order_by_descending(score).to_vector()) == "ceafbd"));
+
+	ECHO_IF_FAILED2("order_by take", (names(qolor::from(rows).order_by(score).take(3).to_vector()) == "bda"));
+	ECHO_IF_FAILED2("order_by_descending take", (names(qolor::from(rows).order_by_descending(score).take(4).to_vector()) == "ceaf"));
+	ECHO_IF_FAILED2("order_by take all", (names(qolor::from(rows).order_by(score).take(100).to_vector()) == "bdafec"));
+	ECHO_IF_FAILED2("order_by take none", (qolor::from(rows).order_by(score).take(0).to_vector().empty()));
+	ECHO_IF_FAILED2("order_by take take", (names(qolor::from(rows).order_by(score).take(4).take(2).to_vector()) == "bd"));
+	ECHO_IF_FAILED2("order_by first", (std::get<0>(qolor::from(rows).order_by_descending(score).first()) == "c"));
+
+	std::string iterated;
+	for (auto const& r : qolor::from(rows).order_by(score).take(2)) iterated += std::get<0>(r);
+	ECHO_IF_FAILED2("order_by iteration", (iterated == "bd"));
+
+	// The result is an iterable like any other.
+	auto name = [](row_t const& r) { return std::get<0>(r); };
+	ECHO_IF_FAILED2("order_by select", (qolor::from(rows).order_by(score).select(name).to_vector()
+		== std::vector<std::string>({ "b", "d", "a", "f", "e", "c" })));
+	ECHO_IF_FAILED2("order_by take where", (names(qolor::from(rows).order_by(score).take(4)
+		.where([](row_t const& r) { return std::get<1>(r) != 2; }).to_vector()) == "af"));
+	ECHO_IF_FAILED2("order_by skip", (names(qolor::from(rows).order_by_descending(score).skip(4).to_vector()) == "bd"));
+	ECHO_IF_FAILED2("order_by count", (qolor::from(rows).order_by(score).take(3).count() == 3));
+	ECHO_IF_FAILED2("order_by sum", (qolor::from(rows).order_by(score).take(2).select(score).sum() == 4));
+	ECHO_IF_FAILED2("order_by last", (std::get<0>(qolor::from(rows).order_by(score).last()) == "c"));
+
+	// Top-k against a full sort.
+	std::vector<int> numbers;
+	for (int i = 0; i < 10000; ++i) numbers.push_back(int((i * 2654435761u) % 1000));
+	auto ident = [](int const& x) { return x; };
+	auto all = qolor::from(numbers).order_by(ident).to_vector();
+	auto top = qolor::from(numbers).order_by(ident).take(100).to_vector();
+	ECHO_IF_FAILED2("top-k size", (top.size() == 100));
+	ECHO_IF_FAILED2("top-k matches full sort", (std::equal(top.begin(), top.end(), all.begin())));
+
+	// Input-only source.
+	std::istringstream csv("x,3\ny,1\nz,2\n");
+	auto csv_top = qolor::from_csv(csv)
+		.order_by([](std::vector<std::string> const& r) { return std::stoi(r[1]); })
+		.take(2)
+		.to_vector();
+	ECHO_IF_FAILED2("order_by input-only source", (csv_top.size() == 2 && csv_top[0][0] == "y" && csv_top[1][0] == "z"));
+
+	return 0;
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <numeric>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	std::vector<int64_t> values(100000);
+	std::iota(values.begin(), values.end(), 1);
+
+	int64_t expected_sum = 0, expected_count = 0;
+	std::vector<int64_t> expected_squares;
+	for (auto const& v : values) {
+		if (v % 3 == 0) {
+			expected_sum += v * v;
+			++expected_count;
+			expected_squares.push_back(v * v);
+		}
+	}
+
+	auto query = qolor::from(values).parallel(4)
+		.where([](int64_t const& x) { return x % 3 == 0; })
+		.select([](int64_t const& x) { return x * x; });
+
+	ECHO_IF_FAILED2("parallel sum", (query.sum() == expected_sum));
+	ECHO_IF_FAILED2("parallel to_vector keeps the order", (query.to_vector() == expected_squares));
+	ECHO_IF_FAILED2("parallel contains", query.contains(9));
+	ECHO_IF_FAILED2("parallel does not contain", !query.contains(10));
+
+	auto count = qolor::from(values)
+		.where([](int64_t const& x) { return x % 3 == 0; })
+		.select([](int64_t const&) { return int64_t(1); })
+		.parallel(3)
+		.aggregate([](int64_t const& a, int64_t const& b) { return a + b; });
+	ECHO_IF_FAILED2("parallel aggregate", (count == expected_count));
+
+	// Non-commutative but associative: partial results must be merged in order.
+	static const char text[] = "the quick brown fox jumps over the lazy dog";
+	auto upper = qolor::from(text + 0, text + sizeof(text) - 1).parallel(8)
+		.select([](char const& c) { return std::string(1, char(::toupper(c))); })
+		.aggregate([](std::string const& a, std::string const& b) { return a + b; });
+	ECHO_IF_FAILED2("parallel aggregate order", (upper == "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG"));
+
+	std::vector<int> empty;
+	ECHO_IF_FAILED2("parallel empty sum", (qolor::from(empty).parallel(2).sum() == 0));
+	ECHO_IF_FAILED2("parallel empty to_vector", qolor::from(empty).parallel(2).to_vector().empty());
+
+	ECHO_IF_FAILED2("parallel range", (qolor::from(values.data(), 1000).parallel(2).sum() == 500500));
+
+	return 0;
+}
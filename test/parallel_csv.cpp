@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+typedef std::vector<std::vector<std::string>> rows_t;
+typedef qolor::internal::csv::parallel_csv_state state_t;
+typedef qolor::internal::csv::parallel_csv_iterator iter_t;
+
+std::string const path = "parallel_csv_test.csv";
+
+// With chunks much smaller than the rows, so that rows, quoted fields and
+// empty lines are cut by chunk boundaries in every possible place.
+rows_t read(size_t const& num_threads, qolor::row_order const& order, size_t const& chunk_size)
+{
+	auto file = std::make_shared<qolor::utils::mapped_file>(path);
+	auto state = std::make_shared<state_t>(file, ',', num_threads, order, chunk_size);
+	rows_t rows;
+	for (auto const& row : qolor::internal::iterable<iter_t>(iter_t(state), iter_t()))
+		rows.push_back(row.to_strings());
+	return rows;
+}
+
+} // namespace
+
+int main()
+{
+	rows_t expected;
+	std::string contents;
+	for (size_t i = 0; i < 2000; ++i) {
+		std::string const a = std::to_string(i);
+		expected.push_back({ a, (i % 3)? "x,\"" + a + "\"\ny" : "", "z" });
+		contents += a + ",\"" + ((i % 3)? "x,\"\"" + a + "\"\"\ny" : "") + "\",z" + ((i % 2)? "\r\n" : "\n");
+		if (i % 7 == 0) contents += "\n\r\n";
+	}
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << contents;
+	}
+
+	rows_t sorted = expected;
+	std::sort(sorted.begin(), sorted.end());
+
+	for (size_t chunk_size : { 1, 2, 3, 17, 64, 1000, 1 << 20 }) {
+		for (size_t threads : { 1, 3 }) {
+			std::string const name = std::to_string(chunk_size) + " bytes, " + std::to_string(threads) + " threads";
+			ECHO_IF_FAILED2("parallel csv in order, " + name, (read(threads, qolor::row_order::source, chunk_size) == expected));
+			rows_t any = read(threads, qolor::row_order::any, chunk_size);
+			std::sort(any.begin(), any.end());
+			ECHO_IF_FAILED2("parallel csv any order, " + name, (any == sorted));
+		}
+	}
+
+	ECHO_IF_FAILED2("parallel csv query", (qolor::from_csv_file_parallel(path, 2)
+		.where([](qolor::internal::csv::mapped_row const& r) { return r[1].empty(); })
+		.count() == 667));
+
+	// Stopping early stops the workers.
+	{
+		auto q = qolor::from_csv_file_parallel(path, 2);
+		size_t n = 0;
+		for (auto const& row : q) {
+			if (row[0] == "10") break;
+			++n;
+		}
+		ECHO_IF_FAILED2("parallel csv early stop", (n == 10));
+	}
+	std::remove(path.c_str());
+
+	{
+		std::ofstream os(path, std::ios::binary);
+	}
+	ECHO_IF_FAILED2("parallel csv empty", (qolor::from_csv_file_parallel(path, 2).empty()));
+	std::remove(path.c_str());
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+int main()
+{
+	auto twice = [](int const& x) { return 2 * x; };
+
+	// Order and content are preserved, across many wraparounds of a small buffer.
+	for (size_t capacity : { 1, 2, 3, 64, 4096 }) {
+		auto values = qolor::range(0, 10000).select(twice).prefetch(capacity).to_vector();
+		bool ok = (values.size() == 10000);
+		for (size_t i = 0; ok && i < values.size(); ++i) ok = (values[i] == int(2 * i));
+		ECHO_IF_FAILED2("prefetch keeps order", ok);
+	}
+
+	ECHO_IF_FAILED2("prefetch sum", (qolor::range(0, 1000).prefetch(16).sum() == 499500));
+	ECHO_IF_FAILED2("prefetch then where", (qolor::range(0, 100).prefetch(8)
+		.where([](int const& x) { return x % 10 == 0; }).count() == 10));
+
+	std::vector<int> empty;
+	ECHO_IF_FAILED2("prefetch empty", (qolor::from(empty).prefetch().empty()));
+
+	// The consumer may stop early; the producer is stopped when the query goes away.
+	std::vector<int> first;
+	{
+		auto q = qolor::range(0, 1000000).prefetch(32);
+		for (auto const& x : q) {
+			if (x == 5) break;
+			first.push_back(x);
+		}
+	}
+	ECHO_IF_FAILED2("prefetch early stop", (first == std::vector<int>({ 0, 1, 2, 3, 4 })));
+
+	// Either side may be much slower than the other, which then sleeps rather
+	// than spin for as long.
+	auto pause = []() { std::this_thread::sleep_for(std::chrono::milliseconds(50)); };
+	std::clock_t const cpu = std::clock();
+	std::vector<int> slow_consumer;
+	for (auto const& x : qolor::range(0, 200).prefetch(4)) {
+		if (x % 50 == 0) pause();
+		slow_consumer.push_back(x);
+	}
+	auto slow_producer = qolor::range(0, 200)
+		.select([&pause](int const& x) { if (x % 50 == 0) pause(); return x; })
+		.prefetch(4)
+		.to_vector();
+	double const cpu_ms = double(std::clock() - cpu) * 1000 / CLOCKS_PER_SEC;
+	ECHO_IF_FAILED2("prefetch slow consumer", (slow_consumer == qolor::range(0, 200).to_vector()));
+	ECHO_IF_FAILED2("prefetch slow producer", (slow_producer == slow_consumer));
+	ECHO_IF_FAILED2("prefetch sleeps", (cpu_ms < 100));
+
+	// Exceptions reach the consumer after the elements produced before them.
+	std::vector<int> before;
+	bool thrown = false;
+	try {
+		auto q = qolor::range(0, 100)
+			.select([](int const& x) { if (x == 50) throw std::runtime_error("bad row"); return x; })
+			.prefetch(8);
+		for (auto const& x : q) before.push_back(x);
+	}
+	catch (std::runtime_error const& e) {
+		thrown = (std::string(e.what()) == "bad row");
+	}
+	ECHO_IF_FAILED2("prefetch rethrows", thrown);
+	ECHO_IF_FAILED2("prefetch elements before exception", (before.size() == 50));
+
+	// Input-only source parsed on the producer thread.
+	std::ostringstream text;
+	for (int i = 0; i < 1000; ++i) text << i << ",row" << i << "\n";
+	std::istringstream csv(text.str());
+	auto rows = qolor::from_csv(csv).prefetch(64)
+		.select([](std::vector<std::string> const& r) { return std::stoi(r[0]); })
+		.to_vector();
+	bool csv_ok = (rows.size() == 1000);
+	for (size_t i = 0; csv_ok && i < rows.size(); ++i) csv_ok = (rows[i] == int(i));
+	ECHO_IF_FAILED2("prefetch csv", csv_ok);
+
+	return 0;
+}
@@ -27,8 +27,8 @@ int main()
 		.where([](const int&x)->bool { return (x%3) == 0 || (x%5) == 0; })
 		.sum();
 
-	ECHO_IF_FAILED2("Problem 1", (withqolor == classic));
-	//std::cout << TESTFN2("Problem 1", (withqolor == classic)) << std::endl;
+	ECHO_IF_FAILED2("Problem 1", (size_t(withqolor) == classic));
+	//std::cout << TESTFN2("Problem 1", (size_t(withqolor) == classic)) << std::endl;
 	//qolor::debug::test(withqolor, "With qolor");
 	//qolor::debug::test_type(withqolor, "With qolor");
 	
@@ -39,8 +39,8 @@ int main()
 		.select([](const int& x){ return 2*x; })
 		.sum();
 	
-	ECHO_IF_FAILED2("Problem 1 (*2)", (withqolor2 == 2 * classic));
-	//std::cout << TESTFN2("Problem 1 (*2)", (withqolor2 == 2 * classic)) << std::endl;
+	ECHO_IF_FAILED2("Problem 1 (*2)", (size_t(withqolor2) == 2 * classic));
+	//std::cout << TESTFN2("Problem 1 (*2)", (size_t(withqolor2) == 2 * classic)) << std::endl;
 	//qolor::debug::test(withqolor2, "With qolor (*2)");
 	//qolor::debug::test_type(withqolor2, "With qolor (*2)");
 
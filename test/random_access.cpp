@@ -0,0 +1,59 @@
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+template <typename Iterable>
+bool is_random_access(Iterable const&)
+{
+	return std::is_same<typename Iterable::iterator_category, std::random_access_iterator_tag>::value;
+}
+
+int main()
+{
+	std::vector<int> numbers { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	auto twice = [](int const& x) { return 2 * x; };
+
+	auto doubled = qolor::from(numbers).select(twice);
+	ECHO_IF_FAILED2("select keeps random access", is_random_access(doubled));
+	ECHO_IF_FAILED2("select size", (doubled.count() == 10));
+	ECHO_IF_FAILED2("select last", (doubled.last() == 20));
+	ECHO_IF_FAILED2("select skip", (doubled.skip(7).first() == 16));
+	ECHO_IF_FAILED2("select skip all", (doubled.skip(10).empty()));
+	ECHO_IF_FAILED2("select skip past end", (doubled.skip(50).empty()));
+	auto it = doubled.begin();
+	ECHO_IF_FAILED2("select index", (it[3] == 8));
+	auto const& const_it = it;
+	ECHO_IF_FAILED2("select const dereference", (*const_it == 2 && const_it[9] == 20));
+	ECHO_IF_FAILED2("select reference", (std::is_same<std::iterator_traits<decltype(it)>::reference, int>::value));
+
+	std::list<int> linked(numbers.begin(), numbers.end());
+	auto linked_doubled = qolor::from(linked).select(twice);
+	ECHO_IF_FAILED2("select keeps bidirectional", (std::is_same<decltype(linked_doubled)::iterator_category, std::bidirectional_iterator_tag>::value));
+	ECHO_IF_FAILED2("bidirectional skip", (linked_doubled.skip(7).first() == 16));
+	ECHO_IF_FAILED2("bidirectional last", (linked_doubled.last() == 20));
+
+	auto r = qolor::range(0, 100);
+	ECHO_IF_FAILED2("range is random access", is_random_access(r));
+	ECHO_IF_FAILED2("range size", (r.count() == 100));
+	ECHO_IF_FAILED2("range last", (r.last() == 99));
+	ECHO_IF_FAILED2("range skip", (r.skip(40).first() == 40));
+	ECHO_IF_FAILED2("range skip select", (r.select(twice).skip(10).first() == 20));
+	ECHO_IF_FAILED2("range distance", (r.end() - r.begin() == 100));
+
+	auto stepped = qolor::range(0, 22, 5);
+	ECHO_IF_FAILED2("stepped range size", (stepped.count() == 5));
+	ECHO_IF_FAILED2("stepped range last", (stepped.last() == 20));
+
+	auto fractions = qolor::range(0.0, 1.0, 0.25);
+	ECHO_IF_FAILED2("floating range size", (fractions.count() == 4));
+	ECHO_IF_FAILED2("floating range skip", (fractions.skip(2).first() == 0.5));
+
+	// Random access sources split into chunks for parallel execution.
+	ECHO_IF_FAILED2("parallel range", (qolor::range(0, 1000).select(twice).parallel(4).sum() == 999000));
+
+	return 0;
+}
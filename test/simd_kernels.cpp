@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+template <typename T>
+void test_type(char const* name)
+{
+	std::vector<T> values;
+	for (uint32_t i = 0; i < 1000; ++i) values.push_back(T((i * 2654435761u) % 97));
+
+	// Every length around the block sizes, at every alignment.
+	for (size_t offset = 0; offset < 4; ++offset) {
+		for (size_t n = 0; n + offset <= 300; ++n) {
+			T const* b = values.data() + offset;
+			auto q = qolor::from(b, b + n);
+
+			T expected_sum = T();
+			for (size_t i = 0; i < n; ++i) expected_sum += b[i];
+
+			if (q.sum() != expected_sum) { ECHO_IF_FAILED2(name, !"sum"); return; }
+			if (q.count() != n) { ECHO_IF_FAILED2(name, !"count"); return; }
+			if (n && q.min() != *std::min_element(b, b + n)) { ECHO_IF_FAILED2(name, !"min"); return; }
+			if (n && q.max() != *std::max_element(b, b + n)) { ECHO_IF_FAILED2(name, !"max"); return; }
+			if (q.count(T(5)) != size_t(std::count(b, b + n, T(5)))) { ECHO_IF_FAILED2(name, !"count value"); return; }
+			if (q.find(T(96)) != std::find(b, b + n, T(96))) { ECHO_IF_FAILED2(name, !"find"); return; }
+			if (q.contains(T(50)) != (std::find(b, b + n, T(50)) != b + n)) { ECHO_IF_FAILED2(name, !"contains"); return; }
+			if (q.contains(T(200))) { ECHO_IF_FAILED2(name, !"contains missing"); return; }
+		}
+	}
+}
+
+int main()
+{
+	std::cout << "simd: " << qolor::simd::isa_name(qolor::simd::active_isa()) << std::endl;
+
+	test_type<char>("char");
+	test_type<int8_t>("int8_t");
+	test_type<uint8_t>("uint8_t");
+	test_type<int16_t>("int16_t");
+	test_type<uint16_t>("uint16_t");
+	test_type<int32_t>("int32_t");
+	test_type<uint32_t>("uint32_t");
+	test_type<int64_t>("int64_t");
+	test_type<uint64_t>("uint64_t");
+	test_type<float>("float");
+	test_type<double>("double");
+
+	// Wrap around on integer overflow, like a sequential loop.
+	std::vector<uint8_t> bytes(1000, 200);
+	ECHO_IF_FAILED2("sum wraps around", (qolor::from(bytes).sum() == uint8_t(200 * 1000)));
+
+	// Vector iterators and strings.
+	std::vector<double> doubles { 3.5, -1.25, 8.0, 2.0 };
+	ECHO_IF_FAILED2("vector min", (qolor::from(doubles).min() == -1.25));
+	ECHO_IF_FAILED2("vector max", (qolor::from(doubles).max() == 8.0));
+	std::string text(100, 'a');
+	text[70] = 'z';
+	ECHO_IF_FAILED2("string find", (qolor::from(text).find('z') - text.begin() == 70));
+
+	// Other sources keep their generic implementation.
+	auto evens = qolor::from(doubles).where([](double const& x) { return x > 0; });
+	ECHO_IF_FAILED2("generic min", (evens.min() == 2.0));
+	ECHO_IF_FAILED2("generic count", (evens.count() == 3));
+	ECHO_IF_FAILED2("generic count value", (evens.count(8.0) == 1));
+	ECHO_IF_FAILED2("generic find", (*evens.find(8.0) == 8.0));
+
+	std::vector<int> empty;
+	ECHO_IF_FAILED2("empty sum", (qolor::from(empty).sum() == 0));
+	ECHO_IF_FAILED2("empty min", (qolor::from(empty).min() == 0));
+	ECHO_IF_FAILED2("empty find", (qolor::from(empty).find(1) == empty.end()));
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+bool is(qolor::size_estimate const& h, qolor::size_estimate::kind_type const& kind, size_t const& value)
+{
+	return h.kind == kind && (kind == qolor::size_estimate::unknown || h.value == value);
+}
+
+// Counts copies, to check that to_vector() moves what it can.
+struct tracked
+{
+	static int copies;
+	int v;
+	tracked(int x = 0) : v(x) {}
+	tracked(tracked const& o) : v(o.v) { ++copies; }
+	tracked(tracked&& o) : v(o.v) {}
+	tracked& operator=(tracked const& o) { v = o.v; ++copies; return *this; }
+	tracked& operator=(tracked&& o) { v = o.v; return *this; }
+};
+
+int tracked::copies = 0;
+
+} // namespace
+
+int main()
+{
+	typedef qolor::size_estimate est;
+	std::vector<int> numbers { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	auto even = [](int const& x) { return x % 2 == 0; };
+	auto twice = [](int const& x) { return 2 * x; };
+
+	ECHO_IF_FAILED2("source", is(qolor::from(numbers).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("select", is(qolor::from(numbers).select(twice).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("where", is(qolor::from(numbers).where(even).size_hint(), est::upper_bound, 10));
+	ECHO_IF_FAILED2("where select", is(qolor::from(numbers).where(even).select(twice).size_hint(), est::upper_bound, 10));
+	ECHO_IF_FAILED2("take", is(qolor::from(numbers).take(4).size_hint(), est::exact, 4));
+	ECHO_IF_FAILED2("take more", is(qolor::from(numbers).take(40).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("where take", is(qolor::from(numbers).where(even).take(3).size_hint(), est::upper_bound, 3));
+	ECHO_IF_FAILED2("take_while", is(qolor::from(numbers).take_while(even).size_hint(), est::upper_bound, 10));
+	ECHO_IF_FAILED2("skip", is(qolor::from(numbers).skip(3).size_hint(), est::exact, 7));
+	ECHO_IF_FAILED2("select skip", is(qolor::from(numbers).select(twice).skip(8).size_hint(), est::exact, 2));
+	ECHO_IF_FAILED2("take skip", is(qolor::from(numbers).take(5).skip(2).size_hint(), est::exact, 3));
+	ECHO_IF_FAILED2("range", is(qolor::range(0, 10).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("range step", is(qolor::range(0, 10, 3).size_hint(), est::exact, 4));
+	ECHO_IF_FAILED2("range inclusive", is(qolor::range(1, 10, 1, true).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("range double", is(qolor::range(0.0, 1.0, 0.1).size_hint(), est::exact, 10));
+	ECHO_IF_FAILED2("range select", is(qolor::range(0, 10).select(twice).size_hint(), est::exact, 10));
+
+	std::istringstream csv("a\nb\n");
+	ECHO_IF_FAILED2("input-only source", is(qolor::from_csv(csv).size_hint(), est::unknown, 0));
+	ECHO_IF_FAILED2("input-only take", is(qolor::from_csv(csv).take(5).size_hint(), est::upper_bound, 5));
+
+	// Partially iterated take.
+	ECHO_IF_FAILED2("take iteration", (qolor::from(numbers).take(3).to_vector().size() == 3));
+	auto taken = qolor::from(numbers).take(3);
+	auto it = taken.begin();
+	++it;
+	ECHO_IF_FAILED2("started take", is(qolor::internal::size_hint_of<decltype(it)>::get(it, taken.end()), est::exact, 2));
+
+	// Consuming operations of a started take go on from where it is, as
+	// iterating it does.
+	auto skipped = qolor::from(numbers).take(5).skip(2);
+	std::vector<int> pulled;
+	for (auto const& x : skipped) pulled.push_back(x);
+	ECHO_IF_FAILED2("started take pull", (pulled == std::vector<int>({ 3, 4, 5 })));
+	ECHO_IF_FAILED2("started take to_vector", (skipped.to_vector() == pulled));
+	ECHO_IF_FAILED2("started take count", (skipped.count() == 3 && skipped.sum() == 12));
+	ECHO_IF_FAILED2("started take select", (skipped.select(twice).to_vector() == std::vector<int>({ 6, 8, 10 })));
+	ECHO_IF_FAILED2("started take_while", (qolor::from(numbers).take_while([](int const& x) { return x < 5; }).skip(3).to_vector()
+		== std::vector<int>({ 4 })));
+
+	auto doubled = qolor::from(numbers).select(twice).to_vector();
+	ECHO_IF_FAILED2("to_vector select", (doubled.size() == 10 && doubled.capacity() == 10 && doubled[9] == 20));
+	ECHO_IF_FAILED2("to_vector where", (qolor::from(numbers).where(even).to_vector().size() == 5));
+
+	std::vector<tracked> values(100);
+	tracked::copies = 0;
+	auto copied = qolor::from(values).select([](tracked const& t) { return tracked(t.v + 1); }).to_vector();
+	ECHO_IF_FAILED2("to_vector moves produced elements", (tracked::copies == 0 && copied.size() == 100));
+	tracked::copies = 0;
+	auto plain = qolor::from(values).to_vector();
+	ECHO_IF_FAILED2("to_vector copies source once", (tracked::copies == 100));
+
+	return 0;
+}
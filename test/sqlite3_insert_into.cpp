@@ -0,0 +1,114 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include <qolor/sqlite3_query_driver.h>
+#include "testfn.h"
+
+using namespace std;
+using namespace qolor::internal;
+using qolor::text_view;
+
+namespace
+{
+
+int64_t count(sqlite3pp::database& db, char const* sql)
+{
+	sqlite3pp::query qry(db, sql);
+	return (*qry.begin()).get<int64_t>(0);
+}
+
+} // namespace
+
+int main()
+{
+	try {
+		sqlite3pp::database db(":memory:");
+		db.execute("CREATE TABLE foods (id INTEGER PRIMARY KEY, name TEXT, price REAL)");
+
+		// More rows than one INSERT takes, and a rest inserted one by one.
+		std::vector<std::tuple<int, std::string, double>> foods;
+		for (int i = 0; i < 1000; ++i) foods.emplace_back(i, "food " + std::to_string(i), i * 0.5);
+		size_t const n = qolor::from(foods).insert_into(db, "foods", {}, 300);
+		ECHO_IF_FAILED2("rows", n == 1000);
+		ECHO_IF_FAILED2("count", count(db, "SELECT count(*) FROM foods") == 1000);
+		ECHO_IF_FAILED2("values", count(db, "SELECT count(*) FROM foods WHERE name = 'food ' || id AND price = id * 0.5") == 1000);
+		ECHO_IF_FAILED2("committed", sqlite3_get_autocommit(db.get_ptr().get()) != 0);
+
+		// Columns by name, from a query of text_view fields of delimited text.
+		db.execute("CREATE TABLE cities (name TEXT, country TEXT, people INTEGER)");
+		std::istringstream is("FR,Paris,2100000\nDE,Berlin,3600000\nFR,Lyon,520000\n");
+		size_t const cities = qolor::from_csv<text_view, text_view, int64_t>(is)
+			.select([](std::tuple<text_view, text_view, int64_t> const& r) {
+				return std::make_tuple(std::get<1>(r), std::get<0>(r), std::get<2>(r)); })
+			.insert_into(db, "cities", { "name", "country", "people" });
+		ECHO_IF_FAILED2("cities", cities == 3);
+		ECHO_IF_FAILED2("text_view", count(db, "SELECT people FROM cities WHERE name = 'Lyon' AND country = 'FR'") == 520000);
+
+		// Pairs and single values.
+		db.execute("CREATE TABLE pairs (a INTEGER, b TEXT)");
+		std::vector<std::pair<int64_t, char const*>> pairs = { { 1, "one" }, { 2, nullptr } };
+		qolor::from(pairs).insert_into(db, "pairs");
+		ECHO_IF_FAILED2("pairs", count(db, "SELECT count(*) FROM pairs WHERE b = 'one'") == 1);
+		ECHO_IF_FAILED2("null char const*", count(db, "SELECT count(*) FROM pairs WHERE a = 2 AND b IS NULL") == 1);
+
+		// NULL columns read as text_view are inserted as NULL, and empty text
+		// as empty text.
+		db.execute("INSERT INTO pairs VALUES (3, '')");
+		db.execute("CREATE TABLE copies (a INTEGER, b TEXT)");
+		sqlite3pp::query all_pairs(db, "SELECT a, b FROM pairs");
+		qolor::from<int64_t, text_view>(all_pairs).insert_into(db, "copies");
+		ECHO_IF_FAILED2("null text_view", count(db, "SELECT count(*) FROM copies WHERE a = 2 AND b IS NULL") == 1);
+		ECHO_IF_FAILED2("empty text_view", count(db, "SELECT count(*) FROM copies WHERE a = 3 AND b = ''") == 1);
+
+		db.execute("CREATE TABLE numbers (x INTEGER)");
+		std::vector<uint32_t> numbers = { 1, 4000000000u, 3 };
+		qolor::from(numbers).insert_into(db, "numbers");
+		ECHO_IF_FAILED2("unsigned", count(db, "SELECT max(x) FROM numbers") == 4000000000ll);
+
+		// Rows inserted in a transaction of the caller are left to it.
+		{
+			sqlite3pp::transaction xct(db);
+			qolor::from(numbers).insert_into(db, "numbers", {}, 1);
+			ECHO_IF_FAILED2("in transaction", count(db, "SELECT count(*) FROM numbers") == 6);
+		}
+		ECHO_IF_FAILED2("rolled back", count(db, "SELECT count(*) FROM numbers") == 3);
+
+		// A failure rolls back the current batch only.
+		std::vector<std::tuple<int, std::string, double>> more;
+		for (int i = 1000; i < 1100; ++i) more.emplace_back(i, "more", 0);
+		more.emplace_back(5, "duplicate", 0);
+		bool thrown = false;
+		try { qolor::from(more).insert_into(db, "foods", {}, 50); }
+		catch (sqlite3pp::sqlite3_error const&) { thrown = true; }
+		ECHO_IF_FAILED2("constraint", thrown);
+		ECHO_IF_FAILED2("batches kept", count(db, "SELECT count(*) FROM foods") == 1100);
+
+		// Batches are committed every batch_rows rows, even when they are not
+		// made of whole inserts of the most rows.
+		more.clear();
+		for (int i = 1100; i < 1800; ++i) more.emplace_back(i, "more", 0);
+		more.emplace_back(5, "duplicate", 0);
+		thrown = false;
+		try { qolor::from(more).insert_into(db, "foods", {}, 300); }
+		catch (sqlite3pp::sqlite3_error const&) { thrown = true; }
+		ECHO_IF_FAILED2("batch size", (thrown && count(db, "SELECT count(*) FROM foods") == 1700));
+
+		thrown = false;
+		try { qolor::from(foods).insert_into(db, "foods", { "id", "name" }); }
+		catch (sqlite3pp::sqlite3_error const&) { thrown = true; }
+		ECHO_IF_FAILED2("columns", thrown);
+
+		// Names are quoted.
+		db.execute("CREATE TABLE \"my \"\"table\"\"\" (\"order\" INTEGER, \"group\" TEXT)");
+		qolor::from(pairs).insert_into(db, "my \"table\"", { "order", "group" });
+		ECHO_IF_FAILED2("quoted names", count(db, "SELECT count(*) FROM \"my \"\"table\"\"\" WHERE \"group\" = 'one'") == 1);
+	}
+	catch (exception& ex) {
+		ECHO_IF_FAILED2(ex.what(), false);
+	}
+
+	return 0;
+}
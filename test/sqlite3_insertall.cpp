@@ -27,7 +27,7 @@ int main()
 			xct.commit();
 		}
 	}
-	catch (exception ex) {
+	catch (exception& ex) {
 		TEST2(ex.what(), false);
 	}
 
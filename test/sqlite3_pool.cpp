@@ -0,0 +1,86 @@
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <qolor/sqlite3_query_driver.h>
+#include "testfn.h"
+
+using namespace std;
+using namespace qolor::internal;
+
+int main()
+{
+	std::string const path = "sqlite3_pool.db";
+	std::remove(path.c_str());
+
+	try {
+		sqlite3pp::database_pool::options opts;
+		opts.size = 3;
+		int setups = 0;
+		opts.setup = [&](sqlite3pp::database& db) { ++setups; db.execute("PRAGMA synchronous = NORMAL"); };
+		sqlite3pp::database_pool pool(path.c_str(), opts);
+		ECHO_IF_FAILED2("size", pool.size() == 3);
+		ECHO_IF_FAILED2("setup", setups == 3);
+
+		{
+			auto db = pool.acquire();
+			sqlite3pp::query mode(*db, "PRAGMA journal_mode");
+			ECHO_IF_FAILED2("wal", (*mode.begin()).get<std::string>(0) == "wal");
+			mode.reset();
+			ECHO_IF_FAILED2("statement cache", db->get_statement_cache()->capacity() == 64);
+			db->execute("CREATE TABLE t (x INTEGER)");
+			std::vector<int> xs;
+			for (int i = 1; i <= 100; ++i) xs.push_back(i);
+			qolor::from(xs).insert_into(*db, "t");
+		}
+
+		{
+			// Every connection is handed out once.
+			auto a = pool.acquire();
+			auto b = pool.try_acquire();
+			auto c = pool.try_acquire();
+			auto d = pool.try_acquire();
+			ECHO_IF_FAILED2("leases", (a && b && c && !d));
+			ECHO_IF_FAILED2("distinct", (&*a != &*b && &*b != &*c && &*a != &*c));
+			ECHO_IF_FAILED2("no waits", pool.get_stats().waits == 0);
+
+			// A thread that waits gets the connection given back.
+			sqlite3pp::database* given = &*c;
+			sqlite3pp::database* got = nullptr;
+			std::thread waiter([&]() { got = &*pool.acquire(); });
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			c.release();
+			waiter.join();
+			ECHO_IF_FAILED2("given back", got == given);
+			auto const stats = pool.get_stats();
+			ECHO_IF_FAILED2("waits", (stats.leases == 5 && stats.waits == 1));
+			ECHO_IF_FAILED2("wait time", (stats.max_wait_time.count() > 0 && stats.wait_time == stats.max_wait_time));
+		}
+
+		// Readers on their own connections, from more threads than connections.
+		std::atomic<int64_t> total(0);
+		std::vector<std::thread> readers;
+		for (int t = 0; t < 6; ++t) {
+			readers.emplace_back([&]() {
+				for (int i = 0; i < 50; ++i) {
+					auto db = pool.acquire();
+					sqlite3pp::query qry(*db, "SELECT sum(x) FROM t");
+					total += std::get<0>(qolor::from<int64_t>(qry).first());
+				}
+			});
+		}
+		for (auto& r : readers) r.join();
+		ECHO_IF_FAILED2("readers", total == 6 * 50 * 5050);
+		ECHO_IF_FAILED2("lease count", pool.get_stats().leases == 5 + 300);
+	}
+	catch (exception& ex) {
+		ECHO_IF_FAILED2(ex.what(), false);
+	}
+
+	std::remove(path.c_str());
+	std::remove((path + "-wal").c_str());
+	std::remove((path + "-shm").c_str());
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/sqlite3_query_driver.h>
+#include "testfn.h"
+
+using namespace std;
+using namespace qolor::internal;
+
+int main()
+{
+	try {
+		sqlite3pp::database db(":memory:");
+		db.execute("CREATE TABLE foods (id INTEGER, name TEXT, price REAL)");
+		db.execute("INSERT INTO foods VALUES (1, 'bread', 2.5), (2, 'cheese', 7.25), (3, 'olives', 4.0), (4, 'wine', 12.0)");
+
+		sqlite3pp::query all(db, "SELECT id, name, price FROM foods ORDER BY id");
+		auto rows = qolor::from<int, std::string, double>(all).to_vector();
+		ECHO_IF_FAILED2("rows", rows.size() == 4);
+		ECHO_IF_FAILED2("tuple", (rows[1] == std::make_tuple(2, std::string("cheese"), 7.25)));
+
+		// Each from() runs the query again from its first row.
+		auto names = qolor::from<int, std::string, double>(all)
+			.where([](std::tuple<int, std::string, double> const& r) { return std::get<2>(r) > 3; })
+			.select([](std::tuple<int, std::string, double> const& r) { return std::get<1>(r); })
+			.to_vector();
+		ECHO_IF_FAILED2("where select", (names == std::vector<std::string>{ "cheese", "olives", "wine" }));
+
+		double const total = qolor::from<int, std::string, double>(all)
+			.select([](std::tuple<int, std::string, double> const& r) { return std::get<2>(r); })
+			.sum();
+		ECHO_IF_FAILED2("sum", total == 25.75);
+
+		// Bindings are kept from one scan to the next.
+		sqlite3pp::query cheap(db, "SELECT name, id FROM foods WHERE price < ? ORDER BY id");
+		cheap.bind(1, 5.0);
+		size_t const n = qolor::from<char const*, decltype(std::ignore)>(cheap)
+			.select([](std::tuple<char const*, decltype(std::ignore)> const& r) { return std::string(std::get<0>(r)); })
+			.to_vector().size();
+		ECHO_IF_FAILED2("bound", n == 2);
+		auto const ids = qolor::from<std::string, int64_t>(cheap)
+			.aggregate(int64_t(0), [](int64_t a, std::tuple<std::string, int64_t> const& r) { return a + std::get<1>(r); });
+		ECHO_IF_FAILED2("aggregate", ids == 4);
+
+		sqlite3pp::query empty(db, "SELECT id FROM foods WHERE id > 100");
+		ECHO_IF_FAILED2("empty", qolor::from<int>(empty).empty());
+
+		bool thrown = false;
+		try { qolor::from<int, int>(empty); }
+		catch (sqlite3pp::sqlite3_error const&) { thrown = true; }
+		ECHO_IF_FAILED2("too many types", thrown);
+
+		// SQL results join data from elsewhere in one query.
+		std::vector<std::pair<int, int>> orders = { { 2, 3 }, { 4, 1 }, { 1, 10 } };
+		double const spent = qolor::from<int, std::string, double>(all)
+			.join_on(qolor::from(orders),
+				[](std::tuple<int, std::string, double> const& r) { return std::get<0>(r); },
+				[](std::pair<int, int> const& o) { return o.first; })
+			.select([](std::tuple<int, std::string, double, std::pair<int, int>> const& r) {
+				return std::get<2>(r) * std::get<3>(r).second; })
+			.sum();
+		ECHO_IF_FAILED2("join", spent == 7.25 * 3 + 12.0 + 2.5 * 10);
+	}
+	catch (exception& ex) {
+		ECHO_IF_FAILED2(ex.what(), false);
+	}
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include <iostream>
+#include <string>
+#include <qolor/sqlite3_driver.h>
+#include "testfn.h"
+
+using namespace std;
+using namespace qolor::internal;
+
+namespace
+{
+
+int count_rows(sqlite3pp::query& qry)
+{
+	int n = 0;
+	for (auto i = qry.begin(); i != qry.end(); ++i) ++n;
+	return n;
+}
+
+} // namespace
+
+int main()
+{
+	try {
+		sqlite3pp::database db(":memory:");
+		db.execute("CREATE TABLE t (id INTEGER, name TEXT)");
+		auto const cache = db.get_statement_cache();
+		ECHO_IF_FAILED2("no cache by default", cache->capacity() == 0);
+
+		{
+			sqlite3pp::command cmd(db, "INSERT INTO t VALUES (1, 'a')");
+			cmd.execute();
+		}
+		ECHO_IF_FAILED2("nothing kept without capacity", cache->size() == 0);
+
+		db.set_statement_cache_size(2);
+		for (int i = 2; i <= 5; ++i) {
+			sqlite3pp::command cmd(db, "INSERT INTO t VALUES (?, ?)");
+			cmd.bind(1, i);
+			cmd.bind(2, "b", false);
+			cmd.execute();
+		}
+		ECHO_IF_FAILED2("one miss, then hits", cache->misses() == 1 && cache->hits() == 3);
+		ECHO_IF_FAILED2("kept", cache->size() == 1);
+
+		{
+			// Bindings are cleared when the statement is handed out again.
+			sqlite3pp::command cmd(db, "INSERT INTO t VALUES (?, ?)");
+			cmd.execute();
+			sqlite3pp::query qry(db, "SELECT count(*) FROM t WHERE id IS NULL");
+			ECHO_IF_FAILED2("cleared bindings", (*qry.begin()).get<int>(0) == 1);
+		}
+
+		{
+			// A statement left in the middle of its rows is reset.
+			{
+				sqlite3pp::query qry(db, "SELECT id FROM t ORDER BY id");
+				auto i = qry.begin();
+				ECHO_IF_FAILED2("first row", (*i).get<int>(0) == 0);
+				++i;
+			}
+			sqlite3pp::query qry(db, "SELECT id FROM t ORDER BY id");
+			ECHO_IF_FAILED2("reset", count_rows(qry) == 6);
+		}
+
+		{
+			// ... and when it is given back, so that it does not hold a read
+			// transaction open while it is in the cache.
+			sqlite3_stmt* stmt = nullptr;
+			{
+				sqlite3pp::query qry(db, "SELECT id FROM t ORDER BY id");
+				stmt = qry.get_ptr().get();
+				qry.begin();
+				ECHO_IF_FAILED2("busy", sqlite3_stmt_busy(stmt) != 0);
+			}
+			ECHO_IF_FAILED2("reset when given back", sqlite3_stmt_busy(stmt) == 0);
+		}
+
+		{
+			// The same SQL while its statement is in use gets a statement of
+			// its own.
+			size_t const misses = cache->misses();
+			sqlite3pp::query outer(db, "SELECT id FROM t ORDER BY id");
+			int pairs = 0;
+			for (auto i = outer.begin(); i != outer.end(); ++i) {
+				sqlite3pp::query inner(db, "SELECT id FROM t ORDER BY id");
+				pairs += count_rows(inner);
+			}
+			ECHO_IF_FAILED2("nested", pairs == 36);
+			ECHO_IF_FAILED2("in use", cache->misses() == misses + 6);
+		}
+
+		{
+			// The least recently used statement is finalized.
+			sqlite3pp::query a(db, "SELECT 1");
+			sqlite3pp::query b(db, "SELECT 2");
+			sqlite3pp::query c(db, "SELECT 3");
+			ECHO_IF_FAILED2("capacity", cache->size() == 2);
+		}
+		size_t const hits = cache->hits();
+		{
+			sqlite3pp::query c(db, "SELECT 3");
+			sqlite3pp::query a(db, "SELECT 1");
+		}
+		ECHO_IF_FAILED2("evicted", cache->hits() == hits + 1);
+
+		{
+			// The rest of multiple statements is prepared from the caller's SQL.
+			for (int i = 0; i < 2; ++i) {
+				sqlite3pp::command cmd(db, "DELETE FROM t WHERE id = :id; INSERT INTO t VALUES (:id, 'c')");
+				cmd.bind(":id", 100);
+				ECHO_IF_FAILED2("statements", cmd.execute_all() == 2);
+			}
+			sqlite3pp::query qry(db, "SELECT count(*) FROM t WHERE id = 100");
+			ECHO_IF_FAILED2("execute_all", (*qry.begin()).get<int>(0) == 1);
+		}
+
+		{
+			// Statements outlive the database that prepared them.
+			sqlite3pp::database other(":memory:");
+			other.set_statement_cache_size(4);
+			sqlite3pp::query qry(other, "SELECT 42");
+			other.disconnect();
+			ECHO_IF_FAILED2("cleared", other.get_statement_cache()->size() == 0);
+			ECHO_IF_FAILED2("outlived", (*qry.begin()).get<int>(0) == 42);
+		}
+
+		db.set_statement_cache_size(0);
+		ECHO_IF_FAILED2("shrunk", cache->size() == 0);
+	}
+	catch (exception& ex) {
+		ECHO_IF_FAILED2(ex.what(), false);
+	}
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/sqlite3_query_driver.h>
+#include "testfn.h"
+
+using namespace std;
+using namespace qolor::internal;
+using qolor::text_view;
+
+int main()
+{
+	try {
+		sqlite3pp::database db(":memory:");
+		db.execute("CREATE TABLE docs (id INTEGER, body TEXT, data BLOB)");
+		{
+			sqlite3pp::command cmd(db, "INSERT INTO docs VALUES (?, ?, ?)");
+			std::string const body("with\0nul", 8);
+			uint8_t const data[] = { 0, 1, 2, 255 };
+			cmd.bind(1, 1);
+			cmd.bind(2, body.data(), int(body.size()), false);
+			cmd.bind(3, static_cast<void const*>(data), int(sizeof(data)), false);
+			cmd.execute();
+		}
+		db.execute("INSERT INTO docs VALUES (2, NULL, NULL)");
+		db.execute("INSERT INTO docs VALUES (3, 'short', x'')");
+		db.execute(("INSERT INTO docs VALUES (4, '" + std::string(1000, 'x') + "', x'0102')").c_str());
+
+		sqlite3pp::query qry(db, "SELECT id, body, data FROM docs ORDER BY id");
+
+		// Views into the rows, checked while they are the current one.
+		std::vector<size_t> sizes;
+		for (auto i = qry.begin(); i != qry.end(); ++i) {
+			text_view const t = (*i).get<text_view>(1);
+			sqlite3pp::blob_view const b = (*i).get<sqlite3pp::blob_view>(2);
+			int const id = (*i).get<int>(0);
+			if (id == 1) {
+				ECHO_IF_FAILED2("text with nul", (t == text_view("with\0nul", 8)));
+				ECHO_IF_FAILED2("blob", (b.size() == 4 && b[0] == 0 && b[3] == 255));
+			}
+			if (id == 2) ECHO_IF_FAILED2("null", (t.empty() && b.empty() && b.data() == nullptr));
+			if (id == 3) ECHO_IF_FAILED2("empty blob", (t == "short" && b.empty()));
+			sizes.push_back(t.size() + b.size());
+		}
+		ECHO_IF_FAILED2("sizes", (sizes == std::vector<size_t>{ 12, 0, 5, 1002 }));
+
+		auto const total = qolor::from<int, text_view, sqlite3pp::blob_view>(qry)
+			.select([](std::tuple<int, text_view, sqlite3pp::blob_view> const& r) { return std::get<1>(r).size(); })
+			.sum();
+		ECHO_IF_FAILED2("from", total == 1013);
+
+		// Copies keep their storage from one row to the next.
+		std::string body;
+		std::vector<uint8_t> data;
+		std::u16string wide;
+		std::vector<std::string> bodies;
+		qry.reset();
+		for (auto i = qry.begin(); i != qry.end(); ++i) {
+			(*i).get(1, body);
+			(*i).get(2, data);
+			bodies.push_back(body);
+			if ((*i).get<int>(0) == 1) ECHO_IF_FAILED2("blob copy", (data == std::vector<uint8_t>{ 0, 1, 2, 255 }));
+			if ((*i).get<int>(0) == 3) {
+				(*i).get(1, wide);
+				ECHO_IF_FAILED2("utf-16", (wide == u"short"));
+			}
+		}
+		ECHO_IF_FAILED2("copies", (bodies == std::vector<std::string>{ std::string("with\0nul", 8), "", "short", std::string(1000, 'x') }));
+		ECHO_IF_FAILED2("last blob copy", data.size() == 2);
+	}
+	catch (exception& ex) {
+		ECHO_IF_FAILED2(ex.what(), false);
+	}
+
+	return 0;
+}
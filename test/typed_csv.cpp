@@ -0,0 +1,96 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <qolor/all.hpp>
+#include "testfn.h"
+
+namespace
+{
+
+template <typename T>
+T parse(std::string const& s)
+{
+	T v;
+	qolor::internal::csv::parse_field(s.data(), s.data() + s.size(), v);
+	return v;
+}
+
+template <typename T, typename E>
+bool throws(std::string const& s)
+{
+	try { parse<T>(s); }
+	catch (E const&) { return true; }
+	return false;
+}
+
+} // namespace
+
+int main()
+{
+	ECHO_IF_FAILED2("parse int", (parse<int>("42") == 42 && parse<int>("-17") == -17 && parse<int>(" +5 ") == 5));
+	ECHO_IF_FAILED2("parse int empty", (parse<int>("") == 0));
+	ECHO_IF_FAILED2("parse int limits", (parse<int8_t>("-128") == -128 && parse<int8_t>("127") == 127
+		&& parse<int64_t>("-9223372036854775808") == std::numeric_limits<int64_t>::min()
+		&& parse<uint64_t>("18446744073709551615") == std::numeric_limits<uint64_t>::max()));
+	ECHO_IF_FAILED2("parse int out of range", (throws<int8_t, std::out_of_range>("128")
+		&& throws<uint16_t, std::out_of_range>("65536") && throws<uint64_t, std::out_of_range>("18446744073709551616")));
+	ECHO_IF_FAILED2("parse int invalid", (throws<int, std::invalid_argument>("12a")
+		&& throws<int, std::invalid_argument>("-") && throws<unsigned, std::invalid_argument>("-1")
+		&& throws<int, std::invalid_argument>("1.5")));
+
+	ECHO_IF_FAILED2("parse double", (parse<double>("18.22") == 18.22 && parse<double>("-0.5") == -0.5
+		&& parse<double>("1e3") == 1000 && parse<double>(".25") == 0.25 && parse<double>("7.") == 7));
+	ECHO_IF_FAILED2("parse double exact", (parse<double>("0.1") == 0.1 && parse<double>("123456.789e-3") == 123.456789
+		&& parse<double>("9007199254740993") == 9007199254740993.0));
+	ECHO_IF_FAILED2("parse double slow path", (parse<double>("1.7976931348623157e308") == std::numeric_limits<double>::max()
+		&& parse<double>("4.9e-324") == std::numeric_limits<double>::denorm_min()
+		&& parse<double>("3.14159265358979323846264338") == 3.14159265358979323846264338));
+	ECHO_IF_FAILED2("parse double special", (std::isinf(parse<double>("-inf")) && parse<double>("-inf") < 0
+		&& std::isnan(parse<double>("NaN"))));
+	ECHO_IF_FAILED2("parse double invalid", (throws<double, std::invalid_argument>("1.2.3")
+		&& throws<double, std::invalid_argument>("1e") && throws<double, std::invalid_argument>("abc")));
+	ECHO_IF_FAILED2("parse float", (parse<float>("2.5") == 2.5f));
+	ECHO_IF_FAILED2("parse bool", (parse<bool>("true") && !parse<bool>("0") && throws<bool, std::invalid_argument>("yes")));
+
+	// Typed rows from a stream.
+	std::istringstream is("1,2,7,18.22\n\n\"3\",x y,-1,1e-2\r\n4\n");
+	auto rows = qolor::from_csv<int, std::string, int, double>(is).to_vector();
+	typedef std::tuple<int, std::string, int, double> row_t;
+	ECHO_IF_FAILED2("from_csv typed", (rows == std::vector<row_t>({
+		row_t(1, "2", 7, 18.22), row_t(3, "x y", -1, 0.01), row_t(4, "", 0, 0) })));
+
+	std::istringstream is2("a;1;b;2.5\n");
+	auto skipped = qolor::from_csv<decltype(std::ignore), int, decltype(std::ignore), float>(is2, ';').to_vector();
+	ECHO_IF_FAILED2("from_csv typed ignore", (skipped.size() == 1 && std::get<1>(skipped[0]) == 1 && std::get<3>(skipped[0]) == 2.5f));
+
+	std::istringstream is3("1,x\n");
+	bool thrown = false;
+	try { qolor::from_csv<int, int>(is3).to_vector(); }
+	catch (std::invalid_argument const&) { thrown = true; }
+	ECHO_IF_FAILED2("from_csv typed invalid", thrown);
+
+	// Typed rows from a file.
+	std::string const path = "typed_csv_test.csv";
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << "1,\"a\"\"b\",0.5\n2,c,1.5\n";
+	}
+	double sum = qolor::from_csv_file<int, qolor::text_view, double>(path)
+		.select([](std::tuple<int, qolor::text_view, double> const& t) { return std::get<0>(t) * std::get<2>(t); })
+		.sum();
+	std::remove(path.c_str());
+	ECHO_IF_FAILED2("from_csv_file typed", (sum == 3.5));
+
+	// The untyped driver is still there.
+	std::istringstream is4("a,b\n");
+	ECHO_IF_FAILED2("from_csv untyped", (qolor::from_csv(is4).first() == std::vector<std::string>({ "a", "b" })));
+
+	return 0;
+}